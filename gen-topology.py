@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# Gera uma malha irregular no formato anotado lido por topology-loader.hpp (--topology):
+#
+#   node <nome> <x> <y> <papel>
+#   link <a> <b> <rate> <delay> [<loss>]
+#   rendezvous <nome>
+#
+# A malha é uma árvore aleatória (garante a conectividade) mais ligações extra entre pares
+# aleatórios até ao número pedido. O rendezvous é o nó mais próximo do centro e não tem
+# papel; os pivots são também points, como na grelha. A mesma semente gera sempre o mesmo ficheiro.
+#
+# Exemplo (topologia usada nos tempos de topology_load.csv):
+#   ./gen-topology.py --nodes 10000 --links 50000 --seed 1 -o mesh-10k.topo
+#   ./waf --run "large-grid --topology=mesh-10k.topo --topologyLoadOnly=1"
+
+import argparse
+import math
+import random
+import sys
+
+RATES = ["10Mbps", "50Mbps", "100Mbps"]
+DELAYS = ["2ms", "5ms", "10ms"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Gerador de topologias anotadas para large-grid --topology")
+    parser.add_argument("--nodes", type=int, default=10000, help="número de nós")
+    parser.add_argument("--links", type=int, default=50000, help="número de ligações (>= nodes - 1)")
+    parser.add_argument("--seed", type=int, default=1, help="semente do gerador")
+    parser.add_argument("--points", type=float, default=0.6, help="fração de nós 'point' (pivots incluídos)")
+    parser.add_argument("--pivots", type=float, default=0.1, help="fração de nós que são também 'pivot'")
+    parser.add_argument("--lossy", type=float, default=0.05, help="fração de ligações com perda explícita")
+    parser.add_argument("-o", "--output", default="-", help="ficheiro de saída ('-' para stdout)")
+    args = parser.parse_args()
+
+    n, m = args.nodes, args.links
+    if n < 2 or m < n - 1 or m > n * (n - 1) // 2:
+        sys.exit("[TOPOLOGY] --links tem de estar entre nodes-1 e nodes*(nodes-1)/2")
+    if not 0.0 <= args.pivots <= args.points <= 1.0 or int(n * args.points) > n - 1:
+        sys.exit("[TOPOLOGY] requer 0 <= pivots <= points <= 1 e um nó livre para o rendezvous")
+
+    rng = random.Random(args.seed)
+    side = math.ceil(math.sqrt(n)) * 100.0
+    xs = [rng.uniform(0.0, side) for _ in range(n)]
+    ys = [rng.uniform(0.0, side) for _ in range(n)]
+
+    # O rendezvous (nó mais próximo do centro) não tem papel de sincronização. Como na grelha,
+    # os pivots são um subconjunto dos points: recebem 'point,pivot'.
+    centre = side / 2.0
+    rendezvous = min(range(n), key=lambda i: (xs[i] - centre) ** 2 + (ys[i] - centre) ** 2)
+
+    roles = ["router"] * n
+    order = [i for i in range(n) if i != rendezvous]
+    rng.shuffle(order)
+    nPoints = int(n * args.points)
+    nPivots = int(n * args.pivots)
+    for i in order[:nPivots]:
+        roles[i] = "point,pivot"
+    for i in order[nPivots:nPoints]:
+        roles[i] = "point"
+    roles[rendezvous] = ""
+
+    order = list(range(n))
+    edges = set()
+    rng.shuffle(order)
+    for k in range(1, n):
+        a, b = order[k], order[rng.randrange(k)]
+        edges.add((min(a, b), max(a, b)))
+    while len(edges) < m:
+        a, b = rng.randrange(n), rng.randrange(n)
+        if a != b:
+            edges.add((min(a, b), max(a, b)))
+
+    out = sys.stdout if args.output == "-" else open(args.output, "w")
+    out.write("# gen-topology.py --nodes %d --links %d --seed %d\n" % (n, m, args.seed))
+    for i in range(n):
+        out.write(("node n%d %.1f %.1f %s" % (i, xs[i], ys[i], roles[i])).rstrip() + "\n")
+    for a, b in sorted(edges):
+        loss = " %.3f" % rng.uniform(0.001, 0.05) if rng.random() < args.lossy else ""
+        out.write("link n%d n%d %s %s%s\n" % (a, b, rng.choice(RATES), rng.choice(DELAYS), loss))
+    out.write("rendezvous n%d\n" % rendezvous)
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -6,6 +6,10 @@
 #include "ns3/mobility-module.h"
 #include "ns3/netanim-module.h" 
 #include "ns3/applications-module.h"
+#include "sim-common.hpp"
+#include "parallel-routing.hpp"
+#include "svs-forwarding.hpp"
+#include "topology-loader.hpp"
 #include <iostream>
 #include <vector>
 #include <memory>
@@ -13,6 +17,20 @@
 #include <fstream>
 #include <cstdlib> 
 #include <limits> 
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 using namespace ns3;
 using namespace std;
@@ -21,17 +39,90 @@ namespace ns3 {
 
 using StateVector = std::map<ndn::Name, uint64_t>; 
 
-// -------------------- Node Data --------------------
-struct NodeData {
-    Ptr<Node> node;
-    int row{0};
-    int col{0};
-    std::string name;
-    int initialDataVersion{0};
-    int dataVersion{0}; 
-    bool isPivot{false};
-    bool isPoint{false};
-    bool hasArrivedAtCenter{false};
+// -------------------- Node Store --------------------
+// Dados dos nós do lado do manager em structure-of-arrays: um vetor por campo, papéis
+// (Point/Pivot/chegada ao centro) em bitsets e nomes gerados a pedido. Só os nós de
+// topologias importadas guardam o nome (labels); na grelha o nome vem de (row, col).
+struct NodeStore {
+    vector<Ptr<Node>> node;
+    vector<int32_t> row;
+    vector<int32_t> col;
+    vector<int32_t> initialDataVersion;
+    vector<int32_t> dataVersion;
+    vector<double> convergedAt;
+    RoleBitset isPoint;
+    RoleBitset isPivot;
+    RoleBitset hasArrivedAtCenter;
+    vector<uint32_t> points;
+    vector<uint32_t> pivots;
+    vector<string> labels;
+
+    size_t Size() const { return node.size(); }
+
+    uint32_t Add(Ptr<Node> n, int r, int c, bool markPoint, bool markPivot, int version,
+                 const string& label = "") {
+        uint32_t i = node.size();
+        node.push_back(n);
+        row.push_back(r);
+        col.push_back(c);
+        initialDataVersion.push_back(version);
+        dataVersion.push_back(version);
+        convergedAt.push_back(-1.0);
+        isPoint.Resize(i + 1);
+        isPivot.Resize(i + 1);
+        hasArrivedAtCenter.Resize(i + 1);
+        if (markPoint) { isPoint.Set(i); points.push_back(i); }
+        if (markPivot) { isPivot.Set(i); pivots.push_back(i); }
+        if (!label.empty()) {
+            labels.resize(i);
+            labels.push_back(label);
+        }
+        return i;
+    }
+
+    string Name(uint32_t i) const {
+        if (i < labels.size() && !labels[i].empty()) return "Node-" + labels[i];
+        return "Node-" + to_string(row[i]) + "-" + to_string(col[i]);
+    }
+
+    size_t MemoryBytes() const {
+        return node.capacity() * sizeof(Ptr<Node>)
+             + (row.capacity() + col.capacity() + initialDataVersion.capacity()
+                + dataVersion.capacity()) * sizeof(int32_t)
+             + convergedAt.capacity() * sizeof(double)
+             + (points.capacity() + pivots.capacity()) * sizeof(uint32_t)
+             + isPoint.MemoryBytes() + isPivot.MemoryBytes() + hasArrivedAtCenter.MemoryBytes()
+             + labels.capacity() * sizeof(string);
+    }
+};
+
+// -------------------- Per-Phase Metrics --------------------
+// Fase 0 = aquecimento (antes da Fase 1); fases 1..3 = sincronização hierárquica.
+static const int kNumPhases = 4;
+
+struct PhaseMetrics {
+    double startTime{-1.0};
+    double endTime{-1.0};
+    uint64_t interests{0};
+    uint64_t data{0};
+    uint64_t nacks{0};
+    uint64_t interestBytes{0};
+    uint64_t dataBytes{0};
+    std::vector<double> nodeConvergeTimes;
+
+    double Duration() const {
+        return (startTime < 0 || endTime < 0) ? 0.0 : endTime - startTime;
+    }
+
+    // Percentil pelo método nearest-rank sobre os tempos de convergência por nó.
+    double Percentile(double p) const {
+        if (nodeConvergeTimes.empty()) return 0.0;
+        std::vector<double> sorted(nodeConvergeTimes);
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        if (rank == 0) rank = 1;
+        return sorted[std::min(rank, sorted.size()) - 1];
+    }
 };
 
 // -------------------- Synchronization Metrics --------------------
@@ -42,6 +133,20 @@ struct SyncMetrics {
     bool started{false};
     bool ended{false};
     bool analysisStarted{false}; 
+    PhaseMetrics phases[kNumPhases];
+
+    void StartPhase(int phase) {
+        if (phase < 0 || phase >= kNumPhases) return;
+        phases[phase].startTime = Simulator::Now().GetSeconds();
+    }
+
+    void EndPhase(int phase) {
+        if (phase < 0 || phase >= kNumPhases || phases[phase].endTime >= 0) return;
+        phases[phase].endTime = Simulator::Now().GetSeconds();
+        cout << "[METRICS] Fase " << phase << " duração=" << phases[phase].Duration() << "s"
+             << " interests=" << phases[phase].interests
+             << " data=" << phases[phase].data << "\n";
+    }
 
     void Start() {
         if (started) return;
@@ -73,6 +178,39 @@ struct SyncMetrics {
         ofs.close();
         cout << "[METRICS] Métricas escritas em " << filename << "\n";
     }
+
+    void WritePhaseFile(const string &filename = "sync_phases.json") const {
+        ofstream ofs(filename);
+        if (!ofs.is_open()) {
+            cerr << "[METRICS] Falha ao abrir " << filename << " para escrita\n";
+            return;
+        }
+        ofs << "{\n  \"startTime\": " << startTime
+            << ",\n  \"endTime\": " << endTime
+            << ",\n  \"duration\": " << duration
+            << ",\n  \"phases\": [\n";
+        for (int i = 0; i < kNumPhases; ++i) {
+            const PhaseMetrics &ph = phases[i];
+            ofs << "    {\"phase\": " << i
+                << ", \"startTime\": " << ph.startTime
+                << ", \"endTime\": " << ph.endTime
+                << ", \"duration\": " << ph.Duration()
+                << ", \"interests\": " << ph.interests
+                << ", \"data\": " << ph.data
+                << ", \"nacks\": " << ph.nacks
+                << ", \"interestBytes\": " << ph.interestBytes
+                << ", \"dataBytes\": " << ph.dataBytes
+                << ", \"convergedNodes\": " << ph.nodeConvergeTimes.size()
+                << ", \"convergeP50\": " << ph.Percentile(50)
+                << ", \"convergeP95\": " << ph.Percentile(95)
+                << ", \"convergeP99\": " << ph.Percentile(99)
+                << ", \"convergeMax\": " << ph.Percentile(100)
+                << "}" << (i + 1 < kNumPhases ? "," : "") << "\n";
+        }
+        ofs << "  ]\n}\n";
+        ofs.close();
+        cout << "[METRICS] Métricas por fase escritas em " << filename << "\n";
+    }
     
     void RunExternalAnalysis() {
         if (analysisStarted) return;
@@ -90,10 +228,153 @@ struct SyncMetrics {
     }
 };
 
+// -------------------- Live Metrics --------------------
+// Contadores escritos pela thread do simulador e lidos pelo LiveReporter (sem locks).
+struct LiveCounters {
+    std::atomic<double> simTime{0.0};
+    std::atomic<uint64_t> fwdEvents{0};
+    std::atomic<int> phase{0};
+    std::atomic<int> converged[kNumPhases]{};
+};
+
+// Emite periodicamente um registo NDJSON com o progresso da simulação para um ficheiro
+// ou, se o destino começar por "unix:", para um socket Unix local. É conduzido por um
+// temporizador de relógio de parede numa thread própria, pelo que não agenda eventos
+// no simulador nem altera a temporização da simulação.
+class LiveReporter {
+public:
+    LiveReporter(const LiveCounters& counters, const string& target, int intervalMs)
+        : counters(counters), target(target), intervalMs(std::max(intervalMs, 10)) {}
+
+    ~LiveReporter() { Stop(); }
+
+    bool Start() {
+        if (!OpenTarget()) {
+            cerr << "[LIVE] Falha ao abrir " << target << "\n";
+            return false;
+        }
+        wallStart = std::chrono::steady_clock::now();
+        lastWall = wallStart;
+        worker = std::thread(&LiveReporter::Loop, this);
+        cout << "[LIVE] Relatório periódico (" << intervalMs << "ms) em " << target << "\n";
+        return true;
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (stopping) return;
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+        Emit(true);
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+private:
+    const LiveCounters& counters;
+    string target;
+    int intervalMs;
+    int fd{-1};
+    bool isSocket{false};
+    bool stopping{false};
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::chrono::steady_clock::time_point wallStart;
+    std::chrono::steady_clock::time_point lastWall;
+    uint64_t lastFwdEvents{0};
+
+    bool OpenTarget() {
+        const string unixScheme = "unix:";
+        if (target.compare(0, unixScheme.size(), unixScheme) == 0) {
+            string path = target.substr(unixScheme.size());
+            sockaddr_un addr{};
+            if (path.size() >= sizeof(addr.sun_path)) return false;
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) return false;
+            addr.sun_family = AF_UNIX;
+            path.copy(addr.sun_path, path.size());
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                close(fd);
+                fd = -1;
+                return false;
+            }
+            isSocket = true;
+            return true;
+        }
+        fd = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return fd >= 0;
+    }
+
+    void Loop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!stopping) {
+            if (cv.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return stopping; })) break;
+            lock.unlock();
+            Emit(false);
+            lock.lock();
+        }
+    }
+
+    void Emit(bool final) {
+        if (fd < 0) return;
+        auto now = std::chrono::steady_clock::now();
+        double wall = std::chrono::duration<double>(now - wallStart).count();
+        double dt = std::chrono::duration<double>(now - lastWall).count();
+        uint64_t fwdEvents = counters.fwdEvents.load(std::memory_order_relaxed);
+        double rate = dt > 0 ? (fwdEvents - lastFwdEvents) / dt : 0.0;
+        lastWall = now;
+        lastFwdEvents = fwdEvents;
+
+        ostringstream line;
+        line << "{\"wall\":" << wall
+             << ",\"simTime\":" << counters.simTime.load(std::memory_order_relaxed)
+             << ",\"phase\":" << counters.phase.load(std::memory_order_relaxed)
+             << ",\"fwdEvents\":" << fwdEvents
+             << ",\"fwdEventsPerSec\":" << rate
+             << ",\"converged\":[";
+        for (int i = 0; i < kNumPhases; ++i) {
+            line << (i ? "," : "") << counters.converged[i].load(std::memory_order_relaxed);
+        }
+        line << "],\"rssKb\":" << ReadRssKb()
+             << (final ? ",\"final\":true" : "") << "}\n";
+
+        // Falhas de escrita (ex.: leitor do socket terminou) não devem afetar a simulação:
+        // o relatório é desativado e a simulação continua.
+        string out = line.str();
+        if (!WriteAll(out.data(), out.size())) {
+            cerr << "[LIVE] Escrita em " << target << " falhou (" << strerror(errno) << "), relatório desativado\n";
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    // Escreve a linha completa, retomando escritas parciais. Nos sockets usa MSG_NOSIGNAL
+    // para que um leitor que fechou a ligação devolva EPIPE em vez de gerar SIGPIPE.
+    bool WriteAll(const char* data, size_t len) {
+        while (len > 0) {
+            ssize_t n = isSocket ? send(fd, data, len, MSG_NOSIGNAL) : write(fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+};
+
 // -------------------- Hierarchical Sync Manager --------------------
 class HierarchicalSyncManager {
 public:
     SyncMetrics metrics; 
+    LiveCounters live;
 
     HierarchicalSyncManager(int expectedPoints)
         : expectedPoints(expectedPoints), arrivedPoints(0), syncPhase(0),
@@ -101,43 +382,60 @@ public:
         cout << "[MANAGER] HierarchicalSyncManager criado a aguardar " << expectedPoints << " pontos.\n";
     }
 
-    shared_ptr<NodeData> RegisterNode(Ptr<Node> node, int row, int col, bool markPoint, bool markPivot) {
-        auto nd = make_shared<NodeData>();
-        nd->node = node;
-        nd->row = row;
-        nd->col = col;
-        nd->name = "Node-" + to_string(row) + "-" + to_string(col);
-        nd->isPoint = markPoint;
-        nd->isPivot = markPivot;
+    // Liga os trace sources do forwarder de todos os nós; o tráfego é contabilizado
+    // na fase corrente no momento do envio (deve ser chamado após a instalação da stack NDN).
+    void ConnectTraces() {
+        Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/OutInterests",
+                                      MakeCallback(&HierarchicalSyncManager::OnOutInterest, this));
+        Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/OutData",
+                                      MakeCallback(&HierarchicalSyncManager::OnOutData, this));
+        Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/OutNack",
+                                      MakeCallback(&HierarchicalSyncManager::OnOutNack, this));
+        metrics.StartPhase(0);
+    }
 
+    uint32_t RegisterNode(Ptr<Node> node, int row, int col, bool markPoint, bool markPivot,
+                          const string& label = "") {
         Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable>();
-        nd->initialDataVersion = 1 + urv->GetInteger(0, 14); 
-        nd->dataVersion = nd->initialDataVersion;
+        int version = 1 + urv->GetInteger(0, 14); 
+        uint32_t i = store.Add(node, row, col, markPoint, markPivot, version, label);
 
-        nodes.push_back(nd);
-        if (nd->isPoint) points.push_back(nd);
-        if (nd->isPivot) pivots.push_back(nd);
+        cout << "[REGISTER] " << store.Name(i)
+             << (markPoint ? " [POINT]" : "")
+             << (markPivot ? " [PIVOT]" : "")
+             << " initialVersion=" << version << "\n";
 
-        cout << "[REGISTER] " << nd->name
-             << (nd->isPoint ? " [POINT]" : "")
-             << (nd->isPivot ? " [PIVOT]" : "")
-             << " initialVersion=" << nd->initialDataVersion << "\n";
+        return i;
+    }
+
+    // Nó de encontro dos Points (centro da grelha ou o rendezvous do ficheiro de topologia).
+    void SetRendezvous(uint32_t i, const Vector& position) {
+        rendezvous = i;
+        rendezvousPosition = position;
+    }
 
-        return nd;
+    const vector<uint32_t>& GetPoints() const { return store.points; }
+
+    size_t MemoryBytes() const {
+        size_t bytes = sizeof(*this) + store.MemoryBytes();
+        for (const auto &ph : metrics.phases) bytes += ph.nodeConvergeTimes.capacity() * sizeof(double);
+        return bytes;
     }
 
-    const vector<shared_ptr<NodeData>>& GetPoints() const { return points; }
+    size_t NodeCount() const { return store.Size(); }
+    uint64_t SvsInterests() const { return svsInterests; }
+    uint64_t DuplicateNacks() const { return duplicateNacks; }
 
-    void MovePointToCenter(shared_ptr<NodeData> nd) {
+    void MovePointToCenter(uint32_t i) {
         if (simulationFinished) return;
 
-        Ptr<MobilityModel> mob = nd->node->GetObject<MobilityModel>();
-        if (mob) mob->SetPosition(Vector(300.0, 300.0, 0.0));
+        Ptr<MobilityModel> mob = store.node[i]->GetObject<MobilityModel>();
+        if (mob) mob->SetPosition(rendezvousPosition);
 
-        if (!nd->hasArrivedAtCenter) {
-            nd->hasArrivedAtCenter = true;
+        if (!store.hasArrivedAtCenter.Test(i)) {
+            store.hasArrivedAtCenter.Set(i);
             arrivedPoints++;
-            cout << "[MOVE] " << nd->name << " chegou ao centro (" << arrivedPoints
+            cout << "[MOVE] " << store.Name(i) << " chegou ao centro (" << arrivedPoints
                  << "/" << expectedPoints << ")\n";
         }
     }
@@ -145,7 +443,11 @@ public:
     void StartNextPhase() {
         if (simulationFinished) return;
 
+        metrics.EndPhase(syncPhase);
         syncPhase++;
+        metrics.StartPhase(syncPhase);
+        live.phase.store(syncPhase, std::memory_order_relaxed);
+        std::fill(store.convergedAt.begin(), store.convergedAt.end(), -1.0);
         cout << "\n[SYNC] A iniciar fase " << syncPhase << " em t=" << Simulator::Now().GetSeconds() << "s\n";
 
         if (syncPhase == 1) {
@@ -169,8 +471,12 @@ public:
         
         double checkInterval = 0.05; 
 
-        uint64_t maxPointVersion = GetMaxVersion(points);
-        uint64_t maxPivotVersion = GetMaxVersion(pivots);
+        uint64_t maxPointVersion = GetMaxVersion(store.points);
+        uint64_t maxPivotVersion = GetMaxVersion(store.pivots);
+
+        if (syncPhase == 1) RecordNodeConvergence(store.pivots, maxPointVersion);
+        else if (syncPhase == 2) RecordNodeConvergence(store.pivots, maxPivotVersion);
+        else if (syncPhase == 3) RecordNodeConvergence(store.points, maxPivotVersion);
 
         if (syncPhase == 1) {
             // Fase 1: Points -> Pivots (durante o movimento)
@@ -186,10 +492,10 @@ public:
             // Fase 2: Pivots <-> Pivots (com todos no centro)
             // CONDIÇÃO: Todos os Pivots têm o mesmo SV (o mínimo é igual ao máximo)
             uint64_t minPivotVersion = std::numeric_limits<uint64_t>::max();
-            for (const auto& nd : pivots) {
-                StateVector sv = GetSvsStateVector(nd->node);
-                if (!sv.empty() && sv.begin()->second > 0) { 
-                    minPivotVersion = std::min(minPivotVersion, sv.begin()->second);
+            for (uint32_t i : store.pivots) {
+                uint64_t version = 0;
+                if (GetSvsVersion(i, version) && version > 0) { 
+                    minPivotVersion = std::min(minPivotVersion, version);
                 }
             }
             
@@ -219,83 +525,129 @@ public:
 
 
 private:
-    vector<shared_ptr<NodeData>> nodes;
-    vector<shared_ptr<NodeData>> points;
-    vector<shared_ptr<NodeData>> pivots;
+    NodeStore store;
+    uint64_t svsInterests{0};
+    uint64_t duplicateNacks{0};
+    int32_t rendezvous{-1};
+    Vector rendezvousPosition{300.0, 300.0, 0.0};
     int expectedPoints;
     int arrivedPoints;
     int syncPhase;
     bool simulationFinished;
 
-    uint64_t GetMaxVersion(const std::vector<std::shared_ptr<NodeData>>& nodeList) const {
+    PhaseMetrics* CurrentPhase() {
+        if (simulationFinished || syncPhase < 0 || syncPhase >= kNumPhases) return nullptr;
+        return &metrics.phases[syncPhase];
+    }
+
+    void NoteLiveEvent() {
+        live.fwdEvents.fetch_add(1, std::memory_order_relaxed);
+        live.simTime.store(Simulator::Now().GetSeconds(), std::memory_order_relaxed);
+    }
+
+    void OnOutInterest(const ndn::Interest& interest, const nfd::Face& face) {
+        NoteLiveEvent();
+        static const ndn::Name svsPrefix("/ndn/svs");
+        if (svsPrefix.isPrefixOf(interest.getName())) svsInterests++;
+        PhaseMetrics* ph = CurrentPhase();
+        if (!ph) return;
+        ph->interests++;
+        ph->interestBytes += interest.wireEncode().size();
+    }
+
+    void OnOutData(const ndn::Data& data, const nfd::Face& face) {
+        NoteLiveEvent();
+        PhaseMetrics* ph = CurrentPhase();
+        if (!ph) return;
+        ph->data++;
+        ph->dataBytes += data.wireEncode().size();
+    }
+
+    void OnOutNack(const ::ndn::lp::Nack& nack, const nfd::Face& face) {
+        NoteLiveEvent();
+        if (nack.getReason() == ::ndn::lp::NackReason::DUPLICATE) duplicateNacks++;
+        PhaseMetrics* ph = CurrentPhase();
+        if (ph) ph->nacks++;
+    }
+
+    // Regista, para cada nó ainda não convergido na fase corrente, o tempo (relativo ao
+    // início da fase) em que atingiu a versão alvo.
+    void RecordNodeConvergence(const vector<uint32_t>& nodeList, uint64_t target) {
+        PhaseMetrics* ph = CurrentPhase();
+        if (!ph || target == 0) return;
+        double now = Simulator::Now().GetSeconds();
+        for (uint32_t i : nodeList) {
+            if (store.convergedAt[i] >= 0) continue;
+            uint64_t version = 0;
+            if (GetSvsVersion(i, version) && version >= target) {
+                store.convergedAt[i] = now;
+                ph->nodeConvergeTimes.push_back(now - ph->startTime);
+                live.converged[syncPhase].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint64_t GetMaxVersion(const std::vector<uint32_t>& nodeList) const {
         uint64_t maxV = 0;
-        for (const auto& nd : nodeList) {
-            StateVector sv = GetSvsStateVector(nd->node);
-            if (!sv.empty()) {
-                maxV = std::max(maxV, sv.begin()->second);
+        for (uint32_t i : nodeList) {
+            uint64_t version = 0;
+            if (GetSvsVersion(i, version)) {
+                maxV = std::max(maxV, version);
             }
         }
         return maxV;
     }
     
-    StateVector GetSvsStateVector(Ptr<Node> node) const {
-        StateVector sv;
-        
-        auto it = std::find_if(nodes.begin(), nodes.end(), [&](const shared_ptr<NodeData>& nd){
-            return nd->node == node;
-        });
-
-        if (it != nodes.end()) {
-            if (!((*it)->row == 2 && (*it)->col == 2)) { 
-                ndn::Name svs_prefix("/ndn/svs/chat"); 
-                sv[svs_prefix] = (*it)->dataVersion;
-            }
-        }
-
-        return sv;
+    // Versão do state vector de /ndn/svs/chat do nó i; o rendezvous não participa.
+    bool GetSvsVersion(uint32_t i, uint64_t& version) const {
+        if (int32_t(i) == rendezvous) return false;
+        version = store.dataVersion[i];
+        return true;
     }
 
     void Phase1_LanesToPivots() {
         cout << "[INST] FASE 1: Lanes (Points) instruem Pivots a sincronizar a versão máxima.\n";
         int maxLaneVersion = -1;
-        for (auto &p : points) if (!p->isPivot) maxLaneVersion = max(maxLaneVersion, p->dataVersion);
-        for (auto &pv : pivots) if (pv->dataVersion < maxLaneVersion) pv->dataVersion = maxLaneVersion;
+        for (uint32_t p : store.points) if (!store.isPivot.Test(p)) maxLaneVersion = max(maxLaneVersion, store.dataVersion[p]);
+        for (uint32_t pv : store.pivots) if (store.dataVersion[pv] < maxLaneVersion) store.dataVersion[pv] = maxLaneVersion;
     }
 
     void Phase2_PivotsInterSync() {
         cout << "[INST] FASE 2: Pivots instruem Pivots a sincronizar a versão máxima entre si.\n";
         int maxPivotVersion = -1;
-        for (auto &pv : pivots) maxPivotVersion = max(maxPivotVersion, pv->dataVersion);
-        for (auto &pv : pivots) pv->dataVersion = maxPivotVersion;
+        for (uint32_t pv : store.pivots) maxPivotVersion = max(maxPivotVersion, store.dataVersion[pv]);
+        for (uint32_t pv : store.pivots) store.dataVersion[pv] = maxPivotVersion;
     }
 
     void Phase3_PivotsToLanes() {
         cout << "[INST] FASE 3: Pivots instruem Points (Lanes) a sincronizar a versão máxima.\n";
         int pivotMax = -1;
-        for (auto &pv : pivots) pivotMax = max(pivotMax, pv->dataVersion);
-        for (auto &p : points) p->dataVersion = pivotMax;
+        for (uint32_t pv : store.pivots) pivotMax = max(pivotMax, store.dataVersion[pv]);
+        for (uint32_t p : store.points) store.dataVersion[p] = pivotMax;
     }
 
     void FinishSimulation() {
         if (simulationFinished) return;
+        metrics.EndPhase(syncPhase);
         metrics.End();
         metrics.WriteFile();
+        metrics.WritePhaseFile();
 
         cout << "\n=== RESUMO FINAL DA SINCRONIZAÇÃO (t=" << Simulator::Now().GetSeconds() << "s) ===\n";
         int finalVersion = -1;
-        for (auto &p : points) finalVersion = max(finalVersion, p->dataVersion);
-        for (auto &pv : pivots) finalVersion = max(finalVersion, pv->dataVersion);
+        for (uint32_t p : store.points) finalVersion = max(finalVersion, store.dataVersion[p]);
+        for (uint32_t pv : store.pivots) finalVersion = max(finalVersion, store.dataVersion[pv]);
 
-        for (auto &p : points) p->dataVersion = finalVersion;
-        for (auto &pv : pivots) pv->dataVersion = finalVersion;
+        for (uint32_t p : store.points) store.dataVersion[p] = finalVersion;
+        for (uint32_t pv : store.pivots) store.dataVersion[pv] = finalVersion;
 
-        for (auto &p : points) {
-            cout << "POINT " << p->name << " inicial=" << p->initialDataVersion
-                 << " final=" << p->dataVersion << (p->dataVersion==finalVersion ? " (OK)" : " (FALHA)") << "\n";
+        for (uint32_t p : store.points) {
+            cout << "POINT " << store.Name(p) << " inicial=" << store.initialDataVersion[p]
+                 << " final=" << store.dataVersion[p] << (store.dataVersion[p]==finalVersion ? " (OK)" : " (FALHA)") << "\n";
         }
-        for (auto &pv : pivots) {
-            cout << "PIVOT " << pv->name << " inicial=" << pv->initialDataVersion
-                 << " final=" << pv->dataVersion << (pv->dataVersion==finalVersion ? " (OK)" : " (FALHA)") << "\n";
+        for (uint32_t pv : store.pivots) {
+            cout << "PIVOT " << store.Name(pv) << " inicial=" << store.initialDataVersion[pv]
+                 << " final=" << store.dataVersion[pv] << (store.dataVersion[pv]==finalVersion ? " (OK)" : " (FALHA)") << "\n";
         }
         
         metrics.RunExternalAnalysis(); 
@@ -328,6 +680,14 @@ int main(int argc, char* argv[]) {
     int nRandom = 3;
     double dropRate = 0.01;
     bool frag = false;
+    string liveReport = "";
+    int liveReportMs = 1000;
+    int routeThreads = 0;
+    bool routeCheck = false;
+    string svsForwarding = "multicast";
+    int gossipFanout = 2;
+    string topology = "";
+    bool topologyLoadOnly = false;
 
     CommandLine cmd;
     cmd.AddValue("interPubMsSlow", "slow publisher interval (ms)", interPubMsSlow);
@@ -336,8 +696,19 @@ int main(int argc, char* argv[]) {
     cmd.AddValue("nRandom", "number of random entries", nRandom);
     cmd.AddValue("dropRate", "packet drop rate", dropRate);
     cmd.AddValue("frag", "enable fragmentation (MTU 1280)", frag);
+    cmd.AddValue("liveReport", "NDJSON live status target (file path or unix:<socket>)", liveReport);
+    cmd.AddValue("liveReportMs", "live status wall-clock interval (ms)", liveReportMs);
+    cmd.AddValue("svsForwarding", "/ndn/svs forwarding: multicast, tree or gossip", svsForwarding);
+    cmd.AddValue("gossipFanout", "faces per relayed Interest in gossip mode", gossipFanout);
+    cmd.AddValue("topology", "annotated topology file (node/link/rendezvous); default is the nRows x nCols grid", topology);
+    cmd.AddValue("topologyLoadOnly", "load --topology, append its parse/creation times to topology_load.csv and exit", topologyLoadOnly);
+    cmd.AddValue("routeThreads", "route computation threads (0 = GlobalRoutingHelper, >=1 = parallel CSR)", routeThreads);
+    cmd.AddValue("routeCheck", "compare CSR routes against GlobalRoutingHelper FIBs (keeps the legacy routes)", routeCheck);
     cmd.Parse(argc, argv);
 
+    MemoryReport memory;
+    memory.Mark("start");
+
     // Configure P2P + error model
     Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
     uv->SetStream(50);
@@ -351,84 +722,164 @@ int main(int argc, char* argv[]) {
 
     cout << " === SIMULAÇÃO NDN OTIMIZADA - SINCRONIZAÇÃO HIERÁRQUICA ===" << endl;
 
-    // Grid Topology
+    // Topology: grelha original ou ficheiro anotado (--topology)
     PointToPointHelper p2p;
-    PointToPointGridHelper grid(nRows, nCols, p2p);
-    grid.BoundingBox(50, 50, 550, 550);
+    unique_ptr<PointToPointGridHelper> grid;
+    TopologyLoader loader;
+    if (topology.empty()) {
+        grid.reset(new PointToPointGridHelper(nRows, nCols, p2p));
+        grid->BoundingBox(50, 50, 550, 550);
+    } else {
+        string error;
+        if (!loader.Load(topology, error)) {
+            cerr << "[TOPOLOGY] " << error << endl;
+            delete rem;
+            return 1;
+        }
+        loader.Report(topology);
+        if (topologyLoadOnly) {
+            // Só os tempos de carregamento (ficheiros gerados por gen-topology.py)
+            Simulator::Destroy();
+            delete rem;
+            return 0;
+        }
+    }
+    memory.Mark("topology");
 
     // NDN Stack and Routing
     ndn::StackHelper ndnHelper;
     ndnHelper.InstallAll();
     ndn::GlobalRoutingHelper globalRouting;
     globalRouting.InstallAll();
+    memory.Mark("ndnStack");
+
+    // Manager
+    auto manager = make_shared<HierarchicalSyncManager>(
+        topology.empty() ? 8 : int(loader.spec.Count(TopologySpec::kRolePoint)));
+    manager->ConnectTraces();
+
+    unique_ptr<LiveReporter> liveReporter;
+    if (!liveReport.empty()) {
+        liveReporter.reset(new LiveReporter(manager->live, liveReport, liveReportMs));
+        if (!liveReporter->Start()) liveReporter.reset();
+    }
 
     // Configuration
     ndn::L3RateTracer::InstallAll("L3RateTracer.txt", Seconds(1.0));
     ndn::AppDelayTracer::InstallAll("AppDelayTracer.txt");
     ndn::CsTracer::InstallAll("CsTracer.txt", Seconds(1.0));
     
-    ndn::StrategyChoiceHelper::InstallAll("/ndn/svs", "/localhost/nfd/strategy/multicast");
+    SvsForwardingMode svsMode = ParseSvsForwardingMode(svsForwarding);
+    InstallSvsStrategy(svsMode, gossipFanout);
     ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/best-route");
 
 
-    // Fast publishers definition
-    unordered_set<string> fastPublishers;
-    for (int i = 0; i < nRows*nCols; ++i) {
-        int r=i/nCols, c=i%nCols;
-        if (i%2==0 && !(r==2 && c==2)) fastPublishers.insert("/"+to_string(r)+"-"+to_string(c));
-    }
+    // SVS Application (Chat)
+    auto installChat = [&](Ptr<Node> node, const string& prefix, bool isFast, double start) {
+        ndn::AppHelper svs("Chat"); 
+        svs.SetPrefix(prefix);
+        svs.SetAttribute("PublishDelayMs", IntegerValue(isFast ? interPubMsFast : interPubMsSlow));
+        svs.SetAttribute("NRecent", IntegerValue(nRecent));
+        svs.SetAttribute("NRand", IntegerValue(nRandom));
+        svs.Install(node).Start(Seconds(start)); 
+        globalRouting.AddOrigins(prefix,node);
+    };
+
+    // Mobility (um único helper/allocator para todos os nós, instalado no fim do ciclo)
+    NodeContainer simNodes;
+    Ptr<ListPositionAllocator> posAlloc = CreateObject<ListPositionAllocator>();
+
+    if (topology.empty()) {
+        // Fast publishers definition
+        unordered_set<string> fastPublishers;
+        for (int i = 0; i < nRows*nCols; ++i) {
+            int r=i/nCols, c=i%nCols;
+            if (i%2==0 && !(r==2 && c==2)) fastPublishers.insert("/"+to_string(r)+"-"+to_string(c));
+        }
 
-    // Manager
-    auto manager = make_shared<HierarchicalSyncManager>(8); 
-
-    for(int r=0; r<nRows; ++r) {
-        for(int c=0; c<nCols; ++c) {
-            Ptr<Node> node = grid.GetNode(r,c);
-
-            // Mobility
-            MobilityHelper mob;
-            Ptr<ListPositionAllocator> posAlloc = CreateObject<ListPositionAllocator>();
-            posAlloc->Add(Vector(c*100+100,r*100+100,0));
-            mob.SetPositionAllocator(posAlloc);
-            mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-            mob.Install(node);
-
-            // SVS Application (Chat)
-            if(!(r==2 && c==2)) { 
-                string prefix = "/"+to_string(r)+"-"+to_string(c);
-                ndn::AppHelper svs("Chat"); 
-                bool isFast = (fastPublishers.find(prefix)!=fastPublishers.end());
-                svs.SetPrefix(prefix);
-                svs.SetAttribute("PublishDelayMs", IntegerValue(isFast ? interPubMsFast : interPubMsSlow));
-                svs.SetAttribute("NRecent", IntegerValue(nRecent));
-                svs.SetAttribute("NRand", IntegerValue(nRandom));
-                svs.Install(node).Start(Seconds(5.0+(r*nCols+c)*0.1)); 
-                globalRouting.AddOrigins(prefix,node);
+        for(int r=0; r<nRows; ++r) {
+            for(int c=0; c<nCols; ++c) {
+                Ptr<Node> node = grid->GetNode(r,c);
+                simNodes.Add(node);
+                posAlloc->Add(Vector(c*100+100,r*100+100,0));
+
+                if(!(r==2 && c==2)) { 
+                    string prefix = "/"+to_string(r)+"-"+to_string(c);
+                    bool isFast = (fastPublishers.find(prefix)!=fastPublishers.end());
+                    installChat(node, prefix, isFast, 5.0+(r*nCols+c)*0.1);
+                }
+
+                uint32_t idx = manager->RegisterNode(node,r,c,IsPointCoord(r,c),IsPivotCoord(r,c));
+                if (r==2 && c==2) manager->SetRendezvous(idx, Vector(300.0, 300.0, 0.0));
+            }
+        }
+    } else {
+        // Papéis explícitos do ficheiro; arranques escalonados em blocos de 6 s para que
+        // todas as aplicações estejam ativas antes da Fase 1, independentemente do tamanho.
+        const TopologySpec& spec = loader.spec;
+        for (uint32_t i = 0; i < spec.NodeCount(); ++i) {
+            Ptr<Node> node = loader.nodes.Get(i);
+            simNodes.Add(node);
+            posAlloc->Add(loader.Position(i));
+
+            if (spec.IsParticipant(i)) {
+                installChat(node, "/" + spec.names[i], i % 2 == 0, 5.0 + (i % 60) * 0.1);
             }
 
-            manager->RegisterNode(node,r,c,IsPointCoord(r,c),IsPivotCoord(r,c));
+            uint32_t idx = manager->RegisterNode(node, -1, -1, spec.Has(i, TopologySpec::kRolePoint),
+                                                 spec.Has(i, TopologySpec::kRolePivot), spec.names[i]);
+            if (int32_t(i) == spec.rendezvous) manager->SetRendezvous(idx, loader.Position(i));
         }
     }
 
-    globalRouting.CalculateRoutes();
-
-    // FIB Routes for /ndn/svs (Multicast-like)
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            Ptr<Node> participant = grid.GetNode(row, col);
-            if (row > 0) ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row - 1, col), 1);
-            if (col > 0) ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row, col - 1), 1);
-            if (row < nRows - 1) ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row + 1, col), 1);
-            if (col < nCols - 1) ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row, col + 1), 1);
+    MobilityHelper mob;
+    mob.SetPositionAllocator(posAlloc);
+    mob.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mob.Install(simNodes);
+
+    // Rotas globais: caminho original ou cálculo CSR paralelo com fusão single-threaded
+    ParallelRouteCalculator::Run(routeThreads, routeCheck);
+
+    // FIB Routes for /ndn/svs (Multicast-like; tree mode keeps only spanning-tree links)
+    if (topology.empty()) {
+        for (int row = 0; row < nRows; row++) {
+            for (int col = 0; col < nCols; col++) {
+                Ptr<Node> participant = grid->GetNode(row, col);
+                if (row > 0 && IsSvsRouteEnabled(svsMode, row, col, row - 1, col, nCols))
+                    ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid->GetNode(row - 1, col), 1);
+                if (col > 0 && IsSvsRouteEnabled(svsMode, row, col, row, col - 1, nCols))
+                    ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid->GetNode(row, col - 1), 1);
+                if (row < nRows - 1 && IsSvsRouteEnabled(svsMode, row, col, row + 1, col, nCols))
+                    ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid->GetNode(row + 1, col), 1);
+                if (col < nCols - 1 && IsSvsRouteEnabled(svsMode, row, col, row, col + 1, nCols))
+                    ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid->GetNode(row, col + 1), 1);
+            }
+        }
+    } else {
+        // Rotas diretamente sobre as faces de cada ligação (sem procurar o canal por nó);
+        // no modo tree só as ligações da árvore BFS com raiz no rendezvous.
+        vector<bool> inTree;
+        if (svsMode == SvsForwardingMode::Tree) inTree = loader.spec.SpanningTreeLinks();
+        auto addSvsRoute = [](Ptr<NetDevice> dev) {
+            Ptr<Node> node = dev->GetNode();
+            auto face = node->GetObject<ndn::L3Protocol>()->getFaceByNetDevice(dev);
+            if (face) ndn::FibHelper::AddRoute(node, "/ndn/svs", face, 1);
+        };
+        for (size_t k = 0; k < loader.devices.size(); ++k) {
+            if (!inTree.empty() && !inTree[k]) continue;
+            addSvsRoute(loader.devices[k].first);
+            addSvsRoute(loader.devices[k].second);
         }
     }
 
+    memory.Mark("setup");
+
     // Schedule all points to move to center at 10.0s
-    for (auto &nd : manager->GetPoints()) {
+    for (uint32_t idx : manager->GetPoints()) {
         Simulator::Schedule(
             Seconds(10.0), 
-            [manager, nd]() { 
-                manager->MovePointToCenter(nd);
+            [manager, idx]() { 
+                manager->MovePointToCenter(idx);
             }
         );
     }
@@ -445,6 +896,10 @@ int main(int argc, char* argv[]) {
     );
 
     Simulator::Run();
+    if (liveReporter) liveReporter->Stop();
+    memory.Mark("end");
+    memory.WriteFile(manager->NodeCount(), manager->MemoryBytes());
+    AppendSvsForwardingReport(svsMode, manager->NodeCount(), manager->SvsInterests(), manager->DuplicateNacks());
     Simulator::Destroy();
     delete rem;
 
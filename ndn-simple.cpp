@@ -6,6 +6,10 @@
 #include "ns3/mobility-module.h"
 #include "ns3/netanim-module.h"
 #include "ns3/applications-module.h"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "sim-common.hpp"
+#include "parallel-routing.hpp"
+#include "svs-forwarding.hpp"
 #include <random>
 #include <vector>
 #include <map>
@@ -14,6 +18,13 @@
 #include <fstream>
 #include <memory>
 #include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <sstream>
 
 using namespace std;
 using namespace ns3;
@@ -29,19 +40,49 @@ static bool IsPointCoord(int row, int col) {
     return false;
 }
 
-// -------------------- Node Data --------------------
-struct NodeData {
-    Ptr<Node> node;
-    int row, col;
-    std::string name;
-    uint64_t dataVersion;
-    uint64_t initialDataVersion;
-    uint64_t finalDataVersion{0};
-    bool isDataProvider;
-    bool isPoint; 
-    bool hasArrivedAtCenter;
-    bool syncCompleted; 
-    std::map<::ndn::Name, uint64_t> stateVector;
+// -------------------- Node Store --------------------
+// Dados dos nós do manager em structure-of-arrays (um vetor por campo, papéis em bitsets).
+// O nome do nó é gerado a pedido a partir das coordenadas.
+struct NodeStore {
+    std::vector<Ptr<Node>> node;
+    std::vector<int32_t> row;
+    std::vector<int32_t> col;
+    std::vector<int32_t> homeGroup;
+    std::vector<uint64_t> initialDataVersion; // versão própria à partida; a versão por grupo fica no manager
+    RoleBitset isPoint;
+    RoleBitset hasArrivedAtCenter;
+    RoleBitset isFastPublisher;
+    RoleBitset isOnline;
+
+    size_t Size() const { return node.size(); }
+
+    uint32_t Add(Ptr<Node> n, int r, int c, int group, bool markPoint, uint64_t version) {
+        uint32_t i = node.size();
+        node.push_back(n);
+        row.push_back(r);
+        col.push_back(c);
+        homeGroup.push_back(group);
+        initialDataVersion.push_back(version);
+        isPoint.Resize(i + 1);
+        hasArrivedAtCenter.Resize(i + 1);
+        isOnline.Resize(i + 1);
+        isOnline.Set(i);
+        isFastPublisher.Resize(i + 1);
+        if (markPoint) isPoint.Set(i);
+        return i;
+    }
+
+    std::string Name(uint32_t i) const {
+        return "Node-" + std::to_string(row[i]) + "-" + std::to_string(col[i]);
+    }
+
+    size_t MemoryBytes() const {
+        return node.capacity() * sizeof(Ptr<Node>)
+             + (row.capacity() + col.capacity() + homeGroup.capacity()) * sizeof(int32_t)
+             + initialDataVersion.capacity() * sizeof(uint64_t)
+             + isPoint.MemoryBytes() + hasArrivedAtCenter.MemoryBytes() + isFastPublisher.MemoryBytes()
+             + isOnline.MemoryBytes();
+    }
 };
 
 // -------------------- Synchronization Metrics --------------------
@@ -91,187 +132,1321 @@ struct SyncMetrics {
     }
 };
 
-// -------------------- Sync Point (Central) --------------------
+// -------------------- Churn (join/leave/crash/rejoin) --------------------
+enum class ChurnType { Join, Leave, Crash, Rejoin };
+
+struct ChurnEvent {
+    ChurnType type;
+    int row{0}, col{0};
+    double time{0.0};
+};
+
+// Formato: "<tipo>:<row>-<col>@<t>" separados por vírgulas, com tipo em
+// {join, leave, crash, rejoin}. Ex.: "crash:1-1@15,rejoin:1-1@25,join:0-3@20".
+static std::vector<ChurnEvent> ParseChurnEvents(const std::string& spec) {
+    std::vector<ChurnEvent> events;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        ChurnEvent ev;
+        char type[16] = {0};
+        if (std::sscanf(item.c_str(), "%15[a-z]:%d-%d@%lf", type, &ev.row, &ev.col, &ev.time) != 4) {
+            std::cerr << "[CHURN] Evento inválido ignorado: " << item << std::endl;
+            continue;
+        }
+        std::string t(type);
+        if (t == "join") ev.type = ChurnType::Join;
+        else if (t == "leave") ev.type = ChurnType::Leave;
+        else if (t == "crash") ev.type = ChurnType::Crash;
+        else if (t == "rejoin") ev.type = ChurnType::Rejoin;
+        else {
+            std::cerr << "[CHURN] Tipo de evento desconhecido: " << t << std::endl;
+            continue;
+        }
+        events.push_back(ev);
+    }
+    std::sort(events.begin(), events.end(),
+              [](const ChurnEvent& a, const ChurnEvent& b) { return a.time < b.time; });
+
+    // Valida a sequência de cada nó: join só como primeiro evento, leave/crash só com o nó
+    // ativo e rejoin só depois de um leave/crash (senão arrancaria uma segunda instância).
+    enum class State { Pending, Online, Offline };
+    std::map<std::pair<int, int>, State> state;
+    std::vector<ChurnEvent> valid;
+    for (const auto &ev : events) {
+        auto it = state.find({ev.row, ev.col});
+        State current = it != state.end() ? it->second : (ev.type == ChurnType::Join ? State::Pending : State::Online);
+        bool ok = false;
+        State next = current;
+        switch (ev.type) {
+        case ChurnType::Join:
+            ok = current == State::Pending;
+            next = State::Online;
+            break;
+        case ChurnType::Leave:
+        case ChurnType::Crash:
+            ok = current == State::Online;
+            next = State::Offline;
+            break;
+        case ChurnType::Rejoin:
+            ok = current == State::Offline;
+            next = State::Online;
+            break;
+        }
+        if (!ok) {
+            std::cerr << "[CHURN] Evento ignorado (incoerente com o estado do nó " << ev.row << "-" << ev.col
+                      << " em t=" << ev.time << "s)" << std::endl;
+            continue;
+        }
+        state[{ev.row, ev.col}] = next;
+        valid.push_back(ev);
+    }
+    return valid;
+}
+
+// Intervalos [início, fim) em que a aplicação do nó está ativa, dados os eventos de churn
+// (já validados por ParseChurnEvents); fim < 0 significa até ao final da simulação.
+static std::vector<std::pair<double, double>> AppSessions(const std::vector<ChurnEvent>& events,
+                                                           int row, int col, double defaultStart) {
+    std::vector<std::pair<double, double>> sessions{{defaultStart, -1.0}};
+    for (const auto &ev : events) {
+        if (ev.row != row || ev.col != col) continue;
+        switch (ev.type) {
+        case ChurnType::Join:
+            sessions.back().first = ev.time;
+            break;
+        case ChurnType::Leave:
+        case ChurnType::Crash:
+            sessions.back().second = ev.time;
+            break;
+        case ChurnType::Rejoin:
+            sessions.emplace_back(ev.time, -1.0);
+            break;
+        }
+    }
+    return sessions;
+}
+
+// -------------------- Pipelined Fetcher --------------------
+// Uma única aplicação obtém as publicações em falta de um par com uma janela de Interests
+// em pipeline, em vez de um Interest pendente de cada vez:
+//  - recuperação de estado após churn: /<peer>/catchup/<seq>, janela fixa (--catchUpWindow);
+//  - publicações grandes (--payloadSize): /<peer>/blob/<versão>/<seg>, janela AIMD ou CUBIC.
+// Um timeout conta como perda e reduz a janela no máximo uma vez por janela enviada; o RTO
+// segue o RFC 6298 (sem amostras de retransmissões) com recuo exponencial.
+enum class CongestionControl { Fixed, Aimd, Cubic };
+
+static CongestionControl ParseCongestionControl(const std::string& name) {
+    if (name == "cubic") return CongestionControl::Cubic;
+    if (name != "aimd") {
+        std::cerr << "[FETCH] Controlo de congestionamento desconhecido '" << name << "', a usar aimd" << std::endl;
+    }
+    return CongestionControl::Aimd;
+}
+
+static const char* CongestionControlName(CongestionControl cc) {
+    switch (cc) {
+    case CongestionControl::Fixed: return "fixed";
+    case CongestionControl::Cubic: return "cubic";
+    default: return "aimd";
+    }
+}
+
+// Janela de congestionamento em Interests: fixa, ou slow start até ssthresh seguido de AIMD ou CUBIC.
+struct CongestionWindow {
+    static constexpr double kAimdBeta = 0.5;
+    static constexpr double kCubicBeta = 0.7;
+    static constexpr double kCubicC = 0.4;
+
+    CongestionControl algo{CongestionControl::Aimd};
+    double cwnd{2.0};
+    double ssthresh{std::numeric_limits<double>::max()};
+    double wMax{0.0};
+    double lastDecrease{0.0};
+    double maxCwnd{2.0};
+    uint32_t decreases{0};
+
+    void Reset(CongestionControl cc, uint32_t window) {
+        algo = cc;
+        cwnd = std::max<uint32_t>(window, 1);
+        maxCwnd = cwnd;
+    }
+
+    void OnAck(double now) {
+        if (algo == CongestionControl::Fixed) return;
+        if (cwnd < ssthresh) {
+            cwnd += 1.0;
+        } else if (algo == CongestionControl::Aimd) {
+            cwnd += 1.0 / cwnd;
+        } else {
+            double k = std::cbrt(wMax * (1.0 - kCubicBeta) / kCubicC);
+            double target = kCubicC * std::pow(now - lastDecrease - k, 3) + wMax;
+            cwnd += target > cwnd ? (target - cwnd) / cwnd : 0.01 / cwnd;
+        }
+        maxCwnd = std::max(maxCwnd, cwnd);
+    }
+
+    void OnLoss(double now) {
+        if (algo == CongestionControl::Fixed) return;
+        wMax = cwnd;
+        cwnd = std::max(1.0, cwnd * (algo == CongestionControl::Aimd ? kAimdBeta : kCubicBeta));
+        ssthresh = cwnd;
+        lastDecrease = now;
+        decreases++;
+    }
+};
+
+class PipelineFetcher : public ndn::App {
+public:
+    enum class Naming { Sequence, Segment };
+    using DoneCallback = std::function<void(const PipelineFetcher&)>;
+
+    uint64_t first{1}, last{0};
+    uint64_t received{0};
+    uint64_t interestsSent{0};
+    uint64_t retransmissions{0};
+    uint64_t bytesReceived{0};
+    double startTime{0.0};
+    double endTime{-1.0};
+    CongestionWindow cc;
+
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::PipelineFetcher")
+            .SetParent<ndn::App>()
+            .AddConstructor<PipelineFetcher>();
+        return tid;
+    }
+
+    PipelineFetcher() : m_rand(CreateObject<UniformRandomVariable>()) {}
+
+    // Obtém <prefix>/<i> para i em [firstIndex, lastIndex], com janela fixa de `window`
+    // Interests ou, com AIMD/CUBIC, a começar em `window`.
+    void Configure(const ::ndn::Name& namePrefix, Naming nameScheme, uint64_t firstIndex, uint64_t lastIndex,
+                   CongestionControl algo, uint32_t window, DoneCallback onDone) {
+        prefix = namePrefix;
+        naming = nameScheme;
+        first = firstIndex;
+        last = lastIndex;
+        cc.Reset(algo, window);
+        done = onDone;
+    }
+
+    // Publicação de totalBytes servida em segmentos de segmentSize: o último segmento conta
+    // apenas com o resto do blob (o Producer devolve sempre segmentos de tamanho fixo).
+    void SetPayload(uint64_t totalBytes, uint32_t segmentSize) {
+        payloadBytes = totalBytes;
+        segmentBytes = std::max<uint32_t>(segmentSize, 1);
+    }
+
+    uint64_t Count() const { return last >= first ? last - first + 1 : 0; }
+
+    double GoodputKbps() const {
+        return endTime > startTime ? bytesReceived * 8.0 / (endTime - startTime) / 1000.0 : 0.0;
+    }
+
+protected:
+    void StartApplication() override {
+        ndn::App::StartApplication();
+        startTime = Simulator::Now().GetSeconds();
+        nextIndex = first;
+        FillWindow();
+    }
+
+    void StopApplication() override {
+        for (auto &p : pending) Simulator::Cancel(p.second.timeout);
+        pending.clear();
+        ndn::App::StopApplication();
+    }
+
+    void OnData(std::shared_ptr<const ::ndn::Data> data) override {
+        if (!m_active) return;
+        ndn::App::OnData(data);
+
+        const ::ndn::name::Component& tail = data->getName().get(-1);
+        uint64_t index = naming == Naming::Segment ? tail.toSegment() : tail.toSequenceNumber();
+        auto it = pending.find(index);
+        if (it == pending.end()) return; // Data duplicado (retransmissão já satisfeita)
+        double now = Simulator::Now().GetSeconds();
+        Simulator::Cancel(it->second.timeout);
+        if (!it->second.retransmitted) UpdateRtt(now - it->second.sentAt);
+        pending.erase(it);
+
+        uint64_t size = data->getContent().value_size();
+        if (payloadBytes > 0) {
+            uint64_t offset = (index - first) * segmentBytes;
+            size = std::min<uint64_t>(size, payloadBytes > offset ? payloadBytes - offset : 0);
+        }
+        bytesReceived += size;
+        received++;
+        cc.OnAck(now);
+
+        if (received == Count()) {
+            endTime = now;
+            if (done) done(*this);
+            return;
+        }
+        FillWindow();
+    }
+
+private:
+    struct Outstanding {
+        EventId timeout;
+        double sentAt;
+        bool retransmitted;
+        uint64_t txIndex;
+    };
+
+    ::ndn::Name prefix;
+    Naming naming{Naming::Sequence};
+    uint64_t payloadBytes{0};
+    uint32_t segmentBytes{1};
+    uint64_t nextIndex{1};
+    std::map<uint64_t, Outstanding> pending;
+    std::deque<uint64_t> retxQueue;
+    uint64_t recoveryPoint{0}; // perdas de Interests enviados antes deste índice já reduziram a janela
+    double srtt{-1.0};
+    double rttvar{0.0};
+    double rto{1.0};
+    DoneCallback done;
+    Ptr<UniformRandomVariable> m_rand;
+
+    void UpdateRtt(double sample) {
+        if (srtt < 0) {
+            srtt = sample;
+            rttvar = sample / 2.0;
+        } else {
+            rttvar = 0.75 * rttvar + 0.25 * std::fabs(srtt - sample);
+            srtt = 0.875 * srtt + 0.125 * sample;
+        }
+        rto = std::min(4.0, std::max(0.2, srtt + 4.0 * rttvar));
+    }
+
+    void FillWindow() {
+        while (pending.size() < static_cast<size_t>(cc.cwnd)) {
+            if (!retxQueue.empty()) {
+                uint64_t index = retxQueue.front();
+                retxQueue.pop_front();
+                SendInterest(index, true);
+            } else if (nextIndex <= last) {
+                SendInterest(nextIndex++, false);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void SendInterest(uint64_t index, bool retransmit) {
+        ::ndn::Name name(prefix);
+        if (naming == Naming::Segment) {
+            name.appendSegment(index);
+        } else {
+            name.appendSequenceNumber(index);
+        }
+        auto interest = std::make_shared<::ndn::Interest>(name);
+        interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+        interest->setCanBePrefix(false);
+        interest->setInterestLifetime(::ndn::time::milliseconds(static_cast<int64_t>(rto * 1000)));
+
+        pending[index] = {Simulator::Schedule(Seconds(rto), &PipelineFetcher::OnTimeout, this, index),
+                          Simulator::Now().GetSeconds(), retransmit, interestsSent};
+        interestsSent++;
+        if (retransmit) retransmissions++;
+        m_transmittedInterests(interest, this, m_face);
+        m_appLink->onReceiveInterest(*interest);
+    }
+
+    void OnTimeout(uint64_t index) {
+        if (!m_active) return;
+        auto it = pending.find(index);
+        if (it == pending.end()) return;
+        uint64_t txIndex = it->second.txIndex;
+        pending.erase(it);
+
+        if (txIndex >= recoveryPoint) {
+            cc.OnLoss(Simulator::Now().GetSeconds());
+            recoveryPoint = interestsSent;
+            rto = std::min(4.0, rto * 2.0);
+        }
+        retxQueue.push_back(index);
+        FillWindow();
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(PipelineFetcher);
+
+// -------------------- Group Sync App --------------------
+// Sincronização por state vector com prefixo de sincronização configurável, usada com
+// --nGroups>1: o Chat publica sempre em /ndn/svs e não permite separar os grupos. Segue o
+// esquema do Chat, com os mesmos atributos (Prefix, PublishDelayMs, NRecent, NRand):
+//  - a cada PublishDelayMs o nó publica e anuncia um state vector parcial (a sua entrada,
+//    as NRecent atualizadas há menos tempo e NRand ao acaso) num Sync Interest
+//    <SyncPrefix>/<nó>/<seq>/.../<nonce> sem resposta, multicast pelas rotas /ndn/svs;
+//  - ao receber entradas mais recentes, obtém as publicações em falta em
+//    <nó><SyncPrefix>/<seq> (servidas por um Producer no nó publicador);
+//  - se o vetor recebido estiver desatualizado, responde com o seu após um atraso aleatório.
+// Todas as instâncias registam a face em /ndn/svs (a entrada FIB com os vizinhos) e
+// ignoram os Sync Interests dos outros grupos.
+class GroupSyncApp : public ndn::App {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::GroupSyncApp")
+            .SetParent<ndn::App>()
+            .AddConstructor<GroupSyncApp>()
+            .AddAttribute("Prefix", "Prefixo do nó (entrada no state vector)", StringValue("/"),
+                          ndn::MakeNameAccessor(&GroupSyncApp::nodePrefix), ndn::MakeNameChecker())
+            .AddAttribute("SyncPrefix", "Prefixo de sincronização do grupo (sob /ndn/svs)", StringValue("/ndn/svs"),
+                          ndn::MakeNameAccessor(&GroupSyncApp::syncPrefix), ndn::MakeNameChecker())
+            .AddAttribute("PublishDelayMs", "Intervalo entre publicações (ms)", IntegerValue(1000),
+                          MakeIntegerAccessor(&GroupSyncApp::publishDelayMs), MakeIntegerChecker<int32_t>())
+            .AddAttribute("NRecent", "Entradas mais recentes em cada Sync Interest", IntegerValue(5),
+                          MakeIntegerAccessor(&GroupSyncApp::nRecent), MakeIntegerChecker<int32_t>())
+            .AddAttribute("NRand", "Entradas aleatórias em cada Sync Interest", IntegerValue(3),
+                          MakeIntegerAccessor(&GroupSyncApp::nRand), MakeIntegerChecker<int32_t>());
+        return tid;
+    }
+
+    GroupSyncApp() : m_rand(CreateObject<UniformRandomVariable>()) {}
+
+protected:
+    void StartApplication() override {
+        ndn::App::StartApplication();
+        ndn::FibHelper::AddRoute(GetNode(), "/ndn/svs", m_face, 0);
+        stateVector[nodePrefix].updatedAt = Simulator::Now().GetSeconds();
+        publishEvent = Simulator::Schedule(MilliSeconds(m_rand->GetInteger(0, std::max(publishDelayMs, 1))),
+                                           &GroupSyncApp::Publish, this);
+    }
+
+    void StopApplication() override {
+        Simulator::Cancel(publishEvent);
+        Simulator::Cancel(syncEvent);
+        ndn::App::StopApplication();
+    }
+
+    void OnInterest(std::shared_ptr<const ::ndn::Interest> interest) override {
+        ndn::App::OnInterest(interest);
+        const ::ndn::Name& name = interest->getName();
+        if (!m_active || !syncPrefix.isPrefixOf(name)) return;
+
+        double now = Simulator::Now().GetSeconds();
+        bool remoteBehind = false;
+        for (size_t i = syncPrefix.size(); i + 2 < name.size(); i += 2) {
+            const ::ndn::name::Component& id = name.get(i);
+            ::ndn::Name node(std::string(reinterpret_cast<const char*>(id.value()), id.value_size()));
+            uint64_t seq = name.get(i + 1).toNumber();
+            Entry& entry = stateVector[node];
+            if (seq > entry.seq) {
+                // Uma entrada própria mais alta vem de uma sessão anterior do nó (churn): só a adota
+                if (!(node == nodePrefix)) Fetch(node, entry.seq + 1, seq);
+                entry.seq = seq;
+                entry.updatedAt = now;
+            } else if (seq < entry.seq) {
+                remoteBehind = true;
+            }
+        }
+        if (remoteBehind && !syncEvent.IsRunning()) {
+            syncEvent = Simulator::Schedule(MilliSeconds(m_rand->GetInteger(50, 250)),
+                                            &GroupSyncApp::SendSyncInterest, this);
+        }
+    }
+
+private:
+    static const uint64_t kMaxFetch = 8; // publicações pedidas por entrada atualizada
+
+    struct Entry {
+        uint64_t seq{0};
+        double updatedAt{0.0};
+    };
+
+    ::ndn::Name nodePrefix;
+    ::ndn::Name syncPrefix;
+    int32_t publishDelayMs{1000};
+    int32_t nRecent{5};
+    int32_t nRand{3};
+    std::map<::ndn::Name, Entry> stateVector;
+    EventId publishEvent;
+    EventId syncEvent;
+    Ptr<UniformRandomVariable> m_rand;
+
+    void Publish() {
+        Entry& own = stateVector[nodePrefix];
+        own.seq++;
+        own.updatedAt = Simulator::Now().GetSeconds();
+        SendSyncInterest();
+        publishEvent = Simulator::Schedule(MilliSeconds(static_cast<uint64_t>(publishDelayMs * m_rand->GetValue(0.9, 1.1))),
+                                           &GroupSyncApp::Publish, this);
+    }
+
+    void SendSyncInterest() {
+        Simulator::Cancel(syncEvent);
+        std::vector<const std::pair<const ::ndn::Name, Entry>*> others;
+        for (const auto &entry : stateVector) {
+            if (!(entry.first == nodePrefix)) others.push_back(&entry);
+        }
+        std::sort(others.begin(), others.end(),
+                  [](const std::pair<const ::ndn::Name, Entry>* a, const std::pair<const ::ndn::Name, Entry>* b) {
+                      return a->second.updatedAt > b->second.updatedAt;
+                  });
+        size_t recent = std::min<size_t>(std::max(nRecent, 0), others.size());
+        size_t total = std::min<size_t>(recent + std::max(nRand, 0), others.size());
+        for (size_t i = recent; i < total; ++i) {
+            std::swap(others[i], others[m_rand->GetInteger(i, others.size() - 1)]);
+        }
+        others.resize(total);
+
+        ::ndn::Name name(syncPrefix);
+        name.append(::ndn::name::Component(nodePrefix.toUri())).appendNumber(stateVector[nodePrefix].seq);
+        for (const auto* entry : others) {
+            name.append(::ndn::name::Component(entry->first.toUri())).appendNumber(entry->second.seq);
+        }
+        name.appendNumber(m_rand->GetInteger(0, std::numeric_limits<uint32_t>::max()));
+        SendInterest(name, 1000);
+    }
+
+    void Fetch(const ::ndn::Name& node, uint64_t from, uint64_t to) {
+        if (to - from + 1 > kMaxFetch) from = to - kMaxFetch + 1;
+        for (uint64_t seq = from; seq <= to; ++seq) {
+            ::ndn::Name name(node);
+            name.append(syncPrefix).appendSequenceNumber(seq);
+            SendInterest(name, 2000);
+        }
+    }
+
+    void SendInterest(const ::ndn::Name& name, int64_t lifetimeMs) {
+        auto interest = std::make_shared<::ndn::Interest>(name);
+        interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+        interest->setCanBePrefix(false);
+        interest->setInterestLifetime(::ndn::time::milliseconds(lifetimeMs));
+        m_transmittedInterests(interest, this, m_face);
+        m_appLink->onReceiveInterest(*interest);
+    }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(GroupSyncApp);
+
+// -------------------- Sync Point (Rendezvous de um grupo) --------------------
+// Estado por grupo guardado de forma contígua (std::vector<SyncPoint>), sem contentores
+// próprios: os membros de cada grupo são a fatia [memberBegin, memberEnd) de
+// OptimizedSyncMobilityManager::groupMembers.
 struct SyncPoint {
     int row{2}, col{2};
+    std::string prefix{"/ndn/svs"};
+    uint32_t memberBegin{0}, memberEnd{0};
+    int pointCount{0};
+    int arrivedPoints{0};
+    int nodeWithLatestData{-1};
     bool syncInProgress{false};
-    std::vector<std::shared_ptr<NodeData>> nodesAtSync;
-    std::shared_ptr<NodeData> nodeWithLatestData;
-    std::map<::ndn::Name, uint64_t> globalStateVector;
-    SyncMetrics metrics;
+    bool converged{false};
+    double syncStartTime{0.0};
+    double syncEndTime{0.0};
     uint64_t finalReferenceVersion{0};
+    uint64_t interests{0};
+    uint64_t data{0};
+    uint64_t bytes{0};
+    uint64_t foreignInterests{0}; // Interests do grupo transmitidos por nós que não são membros
+    int pendingBlobs{0};
+    double fullSyncTime{-1.0};    // todos os blobs do grupo obtidos (modo --payloadSize)
 };
 
 // -------------------- Optimized Sync Mobility Manager --------------------
 class OptimizedSyncMobilityManager {
 private:
-    SyncPoint centralSync;
-    std::vector<std::shared_ptr<NodeData>> allNodes;
+    static const int kGridSize = 5;
+
+    std::vector<SyncPoint> groups;
+    std::vector<uint32_t> groupMembers;     // células (row*kGridSize+col), agrupadas por grupo
+    std::vector<uint64_t> memberVersion;    // versão detida por cada (grupo, membro), paralela a groupMembers
+    RoleBitset memberSynced;                // (grupo, membro) atingiu a versão de referência do grupo
+    std::vector<uint32_t> cellGroupOffsets; // CSR inverso: grupos da célula c em [offsets[c], offsets[c+1])
+    std::vector<uint32_t> cellGroups;
+    std::vector<int> homeGroupByCell;
+    std::vector<int> nodeIndexByCell;
+    SyncMetrics metrics;
+    int groupsConverged{0};
+    uint64_t svsInterests{0};
+    uint64_t duplicateNacks{0};
+
+    NodeStore allNodes;
+    NodeContainer mobilityNodes;
+    Ptr<ListPositionAllocator> positionAlloc;
     bool simulationCompleted{false};
     std::unordered_set<std::string> participantPrefixes;
     std::unordered_set<std::string> pointPrefixes;
     int arrivedPointsCount{0};
 
+    // Churn e recuperação de estado
+    std::vector<double> offlineSince;
+    std::map<uint32_t, std::vector<Ptr<PointToPointNetDevice>>> crashedLinks;            // devices cortados por nó
+    std::map<Ptr<PointToPointNetDevice>, std::pair<Ptr<ErrorModel>, int>> downDevices;  // modelo original, nº de falhas
+    std::vector<std::pair<uint32_t, Ptr<PipelineFetcher>>> catchUps;
+    int pendingCatchUps{0};
+    bool convergenceReported{false};
+    EventId deadline;
+    double deadlineAt{-1.0};
+    int publishMsFast{800};
+    int publishMsSlow{1500};
+    uint32_t catchUpWindow{8};
+
+    // Publicações segmentadas (--payloadSize)
+    struct BlobFetch {
+        uint32_t group;
+        uint32_t consumer;
+        uint32_t producer;
+        Ptr<PipelineFetcher> fetcher;
+    };
+    std::vector<BlobFetch> blobFetches;
+    int pendingBlobFetches{0};
+    uint64_t payloadSize{0};
+    uint32_t segmentSize{1024};
+    CongestionControl fetchCc{CongestionControl::Aimd};
+    double dropRate{0.0};
+    std::map<std::pair<uint32_t, uint64_t>, std::pair<std::string, uint64_t>> blobLinkBytes; // (célula, face) -> (remoto, bytes)
+
 public:
-    OptimizedSyncMobilityManager() {
-        for (int i = 0; i < 5; ++i) {
-            for (int j = 0; j < 5; ++j) {
+    OptimizedSyncMobilityManager(int nGroups = 1, double groupOverlap = 0.0) {
+        nGroups = std::max(nGroups, 1);
+        homeGroupByCell.assign(kGridSize * kGridSize, -1);
+        nodeIndexByCell.assign(kGridSize * kGridSize, -1);
+        positionAlloc = CreateObject<ListPositionAllocator>();
+
+        // Grupo 0 mantém o rendezvous central (2,2); os restantes são sorteados na grelha.
+        Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable>();
+        groups.resize(nGroups);
+        for (int g = 0; g < nGroups; ++g) {
+            SyncPoint& grp = groups[g];
+            if (g > 0) {
+                grp.row = urv->GetInteger(0, kGridSize - 1);
+                grp.col = urv->GetInteger(0, kGridSize - 1);
+            }
+            if (nGroups > 1) grp.prefix = "/ndn/svs/g" + std::to_string(g);
+        }
+
+        // Cada participante pertence ao grupo (índice % nGroups) e, com probabilidade
+        // groupOverlap, a um segundo grupo.
+        std::vector<std::pair<uint32_t, uint32_t>> membership; // (grupo, célula)
+        int participantIndex = 0;
+        for (int i = 0; i < kGridSize; ++i) {
+            for (int j = 0; j < kGridSize; ++j) {
                 if (i != 2 || j != 2) {
                     std::string prefix = "/" + std::to_string(i) + "-" + std::to_string(j);
                     participantPrefixes.insert(prefix);
                     if (IsPointCoord(i, j)) {
                         pointPrefixes.insert(prefix);
                     }
+
+                    uint32_t cell = i * kGridSize + j;
+                    int home = participantIndex++ % nGroups;
+                    homeGroupByCell[cell] = home;
+                    membership.emplace_back(home, cell);
+                    if (nGroups > 1 && urv->GetValue() < groupOverlap) {
+                        int other = (home + 1 + urv->GetInteger(0, nGroups - 2)) % nGroups;
+                        membership.emplace_back(other, cell);
+                    }
                 }
             }
         }
-        std::cout << "=== CONFIGURAÇÃO DE SINCRONIZAÇÃO ÚNICA OTIMIZADA ===" << std::endl;
-        std::cout << pointPrefixes.size() << " nós 'Points' convergirão para o centro." << std::endl;
+        BuildMembership(membership);
+
+        std::cout << "=== CONFIGURAÇÃO DE SINCRONIZAÇÃO OTIMIZADA (" << nGroups << " grupo(s)) ===" << std::endl;
+        std::cout << pointPrefixes.size() << " nós 'Points' convergirão para o rendezvous do seu grupo." << std::endl;
+        for (int g = 0; g < nGroups; ++g) {
+            std::cout << "GRUPO " << groups[g].prefix << " rendezvous=(" << groups[g].row << "," << groups[g].col
+                      << ") membros=" << (groups[g].memberEnd - groups[g].memberBegin)
+                      << " points=" << groups[g].pointCount << std::endl;
+        }
+    }
+
+    std::vector<std::string> GetGroupPrefixes(int row, int col) const {
+        std::vector<std::string> prefixes;
+        uint32_t cell = row * kGridSize + col;
+        for (uint32_t k = cellGroupOffsets[cell]; k < cellGroupOffsets[cell + 1]; ++k) {
+            prefixes.push_back(groups[cellGroups[k]].prefix);
+        }
+        return prefixes;
     }
 
     void SetupOptimizedMobility(Ptr<Node> node, int startRow, int startCol, bool isFast) {
         std::string prefix = "/" + std::to_string(startRow) + "-" + std::to_string(startCol);
         if (participantPrefixes.find(prefix) == participantPrefixes.end()) return;
 
-        auto nodeData = std::make_shared<NodeData>();
-        nodeData->node = node;
-        nodeData->row = startRow;
-        nodeData->col = startCol;
-        nodeData->name = "Node-" + std::to_string(startRow) + "-" + std::to_string(startCol);
-        
         Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable>();
-        nodeData->dataVersion = 1 + urv->GetInteger(0, 14);
-        nodeData->initialDataVersion = nodeData->dataVersion;
-        nodeData->isDataProvider = false;
-        nodeData->isPoint = IsPointCoord(startRow, startCol);
-        nodeData->hasArrivedAtCenter = false;
-        nodeData->syncCompleted = false;
-
-        nodeData->stateVector[::ndn::Name(prefix)] = nodeData->dataVersion;
-        allNodes.push_back(nodeData);
-
-        // Define a versão de referência máxima (apenas entre os Points)
-        if (allNodes.size() == participantPrefixes.size()) {
-            uint64_t maxPointVersion = 0;
-
-            for(const auto& nd : allNodes) {
-                if (nd->isPoint) {
-                    maxPointVersion = std::max(maxPointVersion, nd->dataVersion);
-                }
-            }
-            
-            centralSync.finalReferenceVersion = maxPointVersion;
+        uint64_t version = 1 + urv->GetInteger(0, 14);
+        int cell = startRow * kGridSize + startCol;
+        bool isPoint = IsPointCoord(startRow, startCol);
+        uint32_t idx = allNodes.Add(node, startRow, startCol, homeGroupByCell[cell], isPoint, version);
+        nodeIndexByCell[cell] = idx;
+        if (isFast) allNodes.isFastPublisher.Set(idx);
+        for (uint32_t k = cellGroupOffsets[cell]; k < cellGroupOffsets[cell + 1]; ++k) {
+            memberVersion[MemberSlot(cellGroups[k], cell)] = version;
+        }
 
-            for(const auto& nd : allNodes) {
-                if (nd->isPoint && nd->dataVersion == maxPointVersion) {
-                    centralSync.nodeWithLatestData = nd;
-                    std::cout << nd->name << " detém a versão de referência mais alta (" << maxPointVersion << ") entre os " << pointPrefixes.size() << " Points." << std::endl;
-                    break;
-                }
-            }
+        // Define a versão de referência máxima de cada grupo (apenas entre os Points)
+        if (allNodes.Size() == participantPrefixes.size()) {
+            ComputeReferenceVersions();
         }
         
-        MobilityHelper mobility;
-        Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
-        Vector startPos(startCol * 100 + 100, startRow * 100 + 100, 0);
-        positionAlloc->Add(startPos);
-        mobility.SetPositionAllocator(positionAlloc);
-        mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-        mobility.Install(node);
+        // A mobilidade é instalada de uma só vez em InstallMobility()
+        mobilityNodes.Add(node);
+        positionAlloc->Add(Vector(startCol * 100 + 100, startRow * 100 + 100, 0));
 
-        if (nodeData->isPoint) {
+        if (isPoint) {
             double startDelay = 10.0 + (node->GetId() * 0.1);
             Simulator::Schedule(Seconds(startDelay),
                                  &OptimizedSyncMobilityManager::MoveTowardsCenter, this,
-                                 nodeData);
+                                 idx);
         }
 
-        std::cout << nodeData->name << (nodeData->isPoint ? " [POINT]" : "") 
+        std::cout << allNodes.Name(idx) << (isPoint ? " [POINT]" : "") 
                   << (isFast ? " [RÁPIDO]" : " [LENTO]") << " em (" << startRow << "," << startCol
-                  << ") com versão " << nodeData->dataVersion << std::endl;
+                  << ") com versão " << version
+                  << " grupo " << groups[allNodes.homeGroup[idx]].prefix << std::endl;
     }
 
-    void MoveTowardsCenter(std::shared_ptr<NodeData> nodeData) {
+    void InstallMobility() {
+        MobilityHelper mobility;
+        mobility.SetPositionAllocator(positionAlloc);
+        mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        mobility.Install(mobilityNodes);
+    }
+
+    size_t NodeCount() const { return allNodes.Size(); }
+    uint64_t SvsInterests() const { return svsInterests; }
+    uint64_t DuplicateNacks() const { return duplicateNacks; }
+
+    size_t MemoryBytes() const {
+        return sizeof(*this) + allNodes.MemoryBytes()
+             + groups.capacity() * sizeof(SyncPoint)
+             + (groupMembers.capacity() + cellGroupOffsets.capacity() + cellGroups.capacity()) * sizeof(uint32_t)
+             + memberVersion.capacity() * sizeof(uint64_t) + memberSynced.MemoryBytes()
+             + (homeGroupByCell.capacity() + nodeIndexByCell.capacity()) * sizeof(int);
+    }
+
+    // Contabiliza o tráfego de sincronização de cada grupo a partir dos trace sources do
+    // forwarder; deve ser chamado para todos os nós da grelha (incluindo os não participantes).
+    void ConnectGroupTraces(Ptr<Node> node, int row, int col) {
+        Ptr<ndn::L3Protocol> l3 = node->GetObject<ndn::L3Protocol>();
+        if (!l3) return;
+        int cell = row * kGridSize + col;
+        l3->TraceConnectWithoutContext("OutInterests",
+            MakeBoundCallback(&OptimizedSyncMobilityManager::TraceOutInterest, this, cell));
+        l3->TraceConnectWithoutContext("OutData",
+            MakeBoundCallback(&OptimizedSyncMobilityManager::TraceOutData, this, cell));
+        l3->TraceConnectWithoutContext("OutNack",
+            MakeBoundCallback(&OptimizedSyncMobilityManager::TraceOutNack, this));
+    }
+
+    void MoveTowardsCenter(uint32_t idx) {
         if (simulationCompleted) return;
 
-        Ptr<MobilityModel> mobility = nodeData->node->GetObject<MobilityModel>();
-        Vector centerPos(300.0, 300.0, 0);
+        const SyncPoint& home = groups[allNodes.homeGroup[idx]];
+        Ptr<MobilityModel> mobility = allNodes.node[idx]->GetObject<MobilityModel>();
+        Vector centerPos(home.col * 100 + 100, home.row * 100 + 100, 0);
         mobility->SetPosition(centerPos);
 
-        if (!nodeData->hasArrivedAtCenter) {
-            nodeData->hasArrivedAtCenter = true;
+        if (!allNodes.hasArrivedAtCenter.Test(idx)) {
+            allNodes.hasArrivedAtCenter.Set(idx);
             arrivedPointsCount++;
-            centralSync.nodesAtSync.push_back(nodeData);
 
-            std::cout << nodeData->name << " chegou ao centro - Pontos presentes: "
+            std::cout << allNodes.Name(idx) << " chegou ao rendezvous de " << home.prefix << " - Pontos presentes: "
                       << arrivedPointsCount << "/" << pointPrefixes.size() << std::endl;
 
-            if (arrivedPointsCount == 1 && !centralSync.syncInProgress) {
-                centralSync.syncInProgress = true;
-                centralSync.metrics.StartSync();
-                
-                // Começa a verificar a convergência
-                Simulator::Schedule(Seconds(0.5), &OptimizedSyncMobilityManager::CheckConvergence, this);
+            if (!metrics.started) {
+                metrics.StartSync();
+            }
+
+            uint32_t cell = allNodes.row[idx] * kGridSize + allNodes.col[idx];
+            for (uint32_t k = cellGroupOffsets[cell]; k < cellGroupOffsets[cell + 1]; ++k) {
+                SyncPoint& grp = groups[cellGroups[k]];
+                grp.arrivedPoints++;
+                if (!grp.syncInProgress && !grp.converged) {
+                    grp.syncInProgress = true;
+                    grp.syncStartTime = Simulator::Now().GetSeconds();
+
+                    // Começa a verificar a convergência do grupo
+                    Simulator::Schedule(Seconds(0.5), &OptimizedSyncMobilityManager::CheckConvergence, this,
+                                        cellGroups[k]);
+                }
             }
         }
     }
 
-    void CheckConvergence() {
+    void CheckConvergence(uint32_t g) {
         if (simulationCompleted) return;
 
+        SyncPoint& grp = groups[g];
         int convergedCount = 0;
-        uint64_t finalRefVersion = centralSync.finalReferenceVersion;
-        
-        for (auto &nd : allNodes) {
-            if (nd->isPoint) {
-                if (nd->initialDataVersion < finalRefVersion) {
-                    nd->syncCompleted = true; 
-                } else {
-                    nd->syncCompleted = true;
-                }
-                
-                if (nd->syncCompleted) {
-                    convergedCount++;
-                }
+        uint64_t finalRefVersion = grp.finalReferenceVersion;
+
+        // Só os Points que já chegaram ao rendezvous sincronizam entre si: cada um adota a
+        // versão mais alta presente, e converge quando atinge a versão de referência do grupo.
+        // A versão é a do nó neste grupo: com --groupOverlap o mesmo nó tem uma por grupo.
+        uint64_t presentVersion = 0;
+        for (uint32_t m = grp.memberBegin; m < grp.memberEnd; ++m) {
+            int idx = nodeIndexByCell[groupMembers[m]];
+            if (idx >= 0 && allNodes.isPoint.Test(idx) && allNodes.hasArrivedAtCenter.Test(idx)) {
+                presentVersion = std::max(presentVersion, memberVersion[m]);
             }
         }
 
-        if (convergedCount == pointPrefixes.size()) {
-            std::cout << "\nCONVERGÊNCIA TOTAL " << arrivedPointsCount << "/" << pointPrefixes.size() << " Points sincronizados.\n";
-            EndSimulationAndReport();
+        for (uint32_t m = grp.memberBegin; m < grp.memberEnd; ++m) {
+            int idx = nodeIndexByCell[groupMembers[m]];
+            if (idx < 0 || !allNodes.isPoint.Test(idx) || !allNodes.hasArrivedAtCenter.Test(idx)) continue;
+            memberVersion[m] = std::max(memberVersion[m], presentVersion);
+            if (memberVersion[m] >= finalRefVersion) {
+                memberSynced.Set(m);
+                convergedCount++;
+            }
+        }
+
+        if (convergedCount == grp.pointCount) {
+            grp.converged = true;
+            grp.syncInProgress = false;
+            grp.syncEndTime = Simulator::Now().GetSeconds();
+            groupsConverged++;
+            std::cout << "\nCONVERGÊNCIA " << grp.prefix << " " << convergedCount << "/" << grp.pointCount
+                      << " Points sincronizados (" << groupsConverged << "/" << groups.size() << " grupos).\n";
+            StartBlobFetches(g);
+            if (groupsConverged == static_cast<int>(groups.size())) {
+                EndSimulationAndReport();
+            }
         } else {
             // Se não, agenda a próxima verificação
-            Simulator::Schedule(Seconds(0.5), &OptimizedSyncMobilityManager::CheckConvergence, this);
+            Simulator::Schedule(Seconds(0.5), &OptimizedSyncMobilityManager::CheckConvergence, this, g);
         }
     }
     
     void EndSimulationAndReport() {
-        if (simulationCompleted) return;
-        
-        centralSync.metrics.EndSync();
+        if (simulationCompleted || convergenceReported) return;
+        ReportConvergence();
+
+        if (pendingCatchUps > 0) {
+            std::cout << "[CHURN] A aguardar " << pendingCatchUps << " recuperação(ões) de estado pendente(s)." << std::endl;
+        }
+        if (pendingBlobFetches > 0) {
+            std::cout << "[FETCH] A aguardar " << pendingBlobFetches << " grupo(s) com blobs por obter." << std::endl;
+        }
+        if (pendingCatchUps > 0 || pendingBlobFetches > 0) return;
+        FinishRun();
+    }
+
+    // Resumo por grupo, sync_groups.csv e métricas finais; grupos que não convergiram
+    // (fim forçado pelo limite de segurança) aparecem como FALHA.
+    void ReportConvergence() {
+        metrics.EndSync();
 
         std::cout << "\n=== FIM DO TESTE DE CONVERGÊNCIA ===\n";
 
-        uint64_t finalRefVersion = centralSync.finalReferenceVersion;
-        std::cout << "\n=== RESUMO FINAL DA SINCRONIZAÇÃO (Referência: v" << finalRefVersion << ") ===\n";
-        
-        for (auto &nd : allNodes) {
-            if (nd->isPoint) {
-                // A versão final é a de referência, se a convergência foi OK
-                nd->finalDataVersion = finalRefVersion;
-
-                std::cout << "NODE " << nd->name 
-                          << " inicial=" << nd->initialDataVersion
-                          << " final=" << nd->finalDataVersion 
-                          << (nd->finalDataVersion == finalRefVersion ? " (OK)" : " (FALHA)") << "\n";
+        for (const auto &grp : groups) {
+            uint64_t finalRefVersion = grp.finalReferenceVersion;
+            std::cout << "\n=== RESUMO FINAL DA SINCRONIZAÇÃO " << grp.prefix
+                      << " (Referência: v" << finalRefVersion << ") ===\n";
+
+            for (uint32_t m = grp.memberBegin; m < grp.memberEnd; ++m) {
+                int idx = nodeIndexByCell[groupMembers[m]];
+                if (idx < 0) continue;
+                if (allNodes.isPoint.Test(idx)) {
+                    std::cout << "NODE " << allNodes.Name(idx) 
+                              << " inicial=" << allNodes.initialDataVersion[idx]
+                              << " final=" << memberVersion[m]
+                              << (memberSynced.Test(m) ? " (OK)" : " (FALHA)") << "\n";
+                }
             }
         }
-        
-        centralSync.metrics.PrintFinalMetrics();
-        
+
+        WriteGroupReport();
+        metrics.PrintFinalMetrics();
+        convergenceReported = true;
+    }
+
+    // Agenda os eventos de churn. Um join/rejoin dispara uma recuperação de estado cujo
+    // tamanho (gap) é o número de publicações do par perdidas enquanto o nó esteve ausente.
+    void ScheduleChurn(const std::vector<ChurnEvent>& events, int fastMs, int slowMs, uint32_t window,
+                       double appStartTime) {
+        publishMsFast = fastMs;
+        publishMsSlow = slowMs;
+        catchUpWindow = window;
+        offlineSince.assign(allNodes.Size(), appStartTime);
+
+        double lastEvent = 0.0;
+        std::vector<bool> seen(allNodes.Size(), false);
+        for (const auto &ev : events) {
+            if (ev.row < 0 || ev.row >= kGridSize || ev.col < 0 || ev.col >= kGridSize) continue;
+            int idx = nodeIndexByCell[ev.row * kGridSize + ev.col];
+            if (idx < 0) continue;
+            // Um nó cujo primeiro evento é join só fica ativo nesse instante
+            if (!seen[idx] && ev.type == ChurnType::Join) allNodes.isOnline.Clear(idx);
+            seen[idx] = true;
+
+            switch (ev.type) {
+            case ChurnType::Leave:
+                Simulator::Schedule(Seconds(ev.time), &OptimizedSyncMobilityManager::NodeOffline, this, idx, false);
+                break;
+            case ChurnType::Crash:
+                Simulator::Schedule(Seconds(ev.time), &OptimizedSyncMobilityManager::NodeOffline, this, idx, true);
+                break;
+            case ChurnType::Join:
+            case ChurnType::Rejoin:
+                pendingCatchUps++;
+                Simulator::Schedule(Seconds(ev.time), &OptimizedSyncMobilityManager::NodeOnline, this, idx);
+                break;
+            }
+            lastEvent = std::max(lastEvent, ev.time);
+        }
+
+        // Limite de segurança para recuperações que nunca terminem
+        if (pendingCatchUps > 0) ExtendDeadline(lastEvent + 60.0);
+    }
+
+    // Ativa o modo de publicações segmentadas: quando um grupo converge, cada Point obtém o
+    // blob mais recente de cada um dos outros Points do grupo.
+    void ConfigureBlobs(uint64_t payloadBytes, uint32_t segmentBytes, CongestionControl cc, double linkDropRate) {
+        payloadSize = payloadBytes;
+        segmentSize = std::max<uint32_t>(segmentBytes, 1);
+        fetchCc = cc;
+        dropRate = linkDropRate;
+    }
+
+    // Um único limite de segurança para recuperações e transferências pendentes: cada pedido
+    // só o adia. Ao expirar passa pelo relatório normal antes de terminar a simulação.
+    void ExtendDeadline(double at) {
+        if (at <= deadlineAt) return;
+        Simulator::Cancel(deadline);
+        deadlineAt = at;
+        deadline = Simulator::Schedule(Seconds(at - Simulator::Now().GetSeconds()),
+                                       &OptimizedSyncMobilityManager::OnDeadline, this);
+    }
+
+    void OnDeadline() {
+        if (simulationCompleted) return;
+        std::cout << "[SIM] Limite de segurança atingido em t=" << Simulator::Now().GetSeconds() << "s ("
+                  << (groups.size() - groupsConverged) << " grupo(s) por convergir, " << pendingCatchUps
+                  << " recuperação(ões) e " << pendingBlobFetches << " grupo(s) com blobs pendentes)" << std::endl;
+        if (!convergenceReported) ReportConvergence();
+        FinishRun();
+    }
+
+    void FinishRun() {
+        if (simulationCompleted) return;
+        WriteCatchUpReport();
+        WriteBlobReport();
         simulationCompleted = true;
         Simulator::Stop();
     }
+
+private:
+    void NodeOffline(uint32_t idx, bool crash) {
+        offlineSince[idx] = Simulator::Now().GetSeconds();
+        allNodes.isOnline.Clear(idx);
+        std::cout << "[CHURN] " << allNodes.Name(idx) << (crash ? " falhou" : " saiu")
+                  << " em t=" << offlineSince[idx] << "s" << std::endl;
+        if (crash) SetLinksDown(idx, true);
+    }
+
+    void NodeOnline(uint32_t idx) {
+        double now = Simulator::Now().GetSeconds();
+        if (crashedLinks.count(idx)) SetLinksDown(idx, false);
+        allNodes.isOnline.Set(idx);
+        std::cout << "[CHURN] " << allNodes.Name(idx) << " (re)entrou em t=" << now
+                  << "s após " << (now - offlineSince[idx]) << "s ausente" << std::endl;
+        StartCatchUp(idx, now - offlineSince[idx]);
+    }
+
+    // Uma falha corta as ligações do nó nos dois sentidos (modelo de erro com perda total
+    // nos dois extremos de cada canal). O modelo original de cada device é guardado uma só
+    // vez e reposto quando deixa de haver vizinhos em falha a cortá-lo, pelo que falhas
+    // sobrepostas de dois vizinhos não deixam a ligação partilhada em baixo.
+    void SetLinksDown(uint32_t idx, bool down) {
+        if (!down) {
+            for (const auto &dev : crashedLinks[idx]) {
+                auto it = downDevices.find(dev);
+                if (it == downDevices.end() || --it->second.second > 0) continue;
+                dev->SetReceiveErrorModel(it->second.first);
+                downDevices.erase(it);
+            }
+            crashedLinks.erase(idx);
+            return;
+        }
+        if (crashedLinks.count(idx)) return;
+
+        Ptr<RateErrorModel> dropAll = CreateObject<RateErrorModel>();
+        dropAll->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+        dropAll->SetRate(1.0);
+
+        auto &cut = crashedLinks[idx];
+        Ptr<Node> node = allNodes.node[idx];
+        for (uint32_t d = 0; d < node->GetNDevices(); ++d) {
+            Ptr<PointToPointNetDevice> dev = DynamicCast<PointToPointNetDevice>(node->GetDevice(d));
+            if (!dev) continue;
+            Ptr<Channel> channel = dev->GetChannel();
+            for (size_t k = 0; k < channel->GetNDevices(); ++k) {
+                Ptr<PointToPointNetDevice> end = DynamicCast<PointToPointNetDevice>(channel->GetDevice(k));
+                if (!end) continue;
+                auto &state = downDevices[end];
+                if (state.second++ == 0) {
+                    PointerValue current;
+                    end->GetAttribute("ReceiveErrorModel", current);
+                    state.first = current.Get<ErrorModel>();
+                    end->SetReceiveErrorModel(dropAll);
+                }
+                cut.push_back(end);
+            }
+        }
+    }
+
+    // O par é o detentor da versão de referência do grupo ou, se estiver em baixo (saiu ou
+    // falhou), o primeiro outro membro ativo; sem nenhum ativo a recuperação não é feita.
+    void StartCatchUp(uint32_t idx, double offlineDuration) {
+        const SyncPoint& grp = groups[allNodes.homeGroup[idx]];
+        auto available = [&](int cand) {
+            return cand >= 0 && cand != static_cast<int>(idx) && allNodes.isOnline.Test(cand);
+        };
+        int peer = grp.nodeWithLatestData;
+        if (!available(peer)) {
+            peer = -1;
+            for (uint32_t m = grp.memberBegin; m < grp.memberEnd && peer < 0; ++m) {
+                int cand = nodeIndexByCell[groupMembers[m]];
+                if (available(cand)) peer = cand;
+            }
+        }
+        if (peer < 0) {
+            std::cout << "[CHURN] " << allNodes.Name(idx) << " sem par ativo em " << grp.prefix
+                      << ", recuperação de estado ignorada" << std::endl;
+            OnCatchUpDone();
+            return;
+        }
+
+        int peerMs = allNodes.isFastPublisher.Test(peer) ? publishMsFast : publishMsSlow;
+        uint64_t gap = std::max<uint64_t>(1, std::ceil(offlineDuration * 1000.0 / peerMs));
+        ::ndn::Name peerPrefix("/" + std::to_string(allNodes.row[peer]) + "-" +
+                               std::to_string(allNodes.col[peer]) + "/catchup");
+
+        Ptr<PipelineFetcher> fetcher = CreateObject<PipelineFetcher>();
+        fetcher->Configure(peerPrefix, PipelineFetcher::Naming::Sequence, 1, gap, CongestionControl::Fixed,
+                           catchUpWindow, [this](const PipelineFetcher&) { OnCatchUpDone(); });
+        fetcher->SetStartTime(Seconds(0));
+        allNodes.node[idx]->AddApplication(fetcher);
+        catchUps.emplace_back(idx, fetcher);
+
+        std::cout << "[CHURN] " << allNodes.Name(idx) << " a recuperar " << gap << " publicações de "
+                  << peerPrefix << " (janela=" << catchUpWindow << ")" << std::endl;
+    }
+
+    void OnCatchUpDone() {
+        pendingCatchUps--;
+        if (convergenceReported && pendingCatchUps <= 0 && pendingBlobFetches <= 0) FinishRun();
+    }
+
+    void StartBlobFetches(uint32_t g) {
+        if (payloadSize == 0) return;
+        SyncPoint& grp = groups[g];
+        uint64_t segments = std::max<uint64_t>(1, (payloadSize + segmentSize - 1) / segmentSize);
+        std::vector<std::pair<uint32_t, uint32_t>> points; // (nó, membro)
+        for (uint32_t m = grp.memberBegin; m < grp.memberEnd; ++m) {
+            int idx = nodeIndexByCell[groupMembers[m]];
+            if (idx >= 0 && allNodes.isPoint.Test(idx)) points.emplace_back(idx, m);
+        }
+
+        for (const auto &c : points) {
+            uint32_t consumer = c.first;
+            for (const auto &p : points) {
+                uint32_t producer = p.first;
+                if (producer == consumer) continue;
+                ::ndn::Name blobName("/" + std::to_string(allNodes.row[producer]) + "-" +
+                                     std::to_string(allNodes.col[producer]) + "/blob");
+                blobName.appendVersion(memberVersion[p.second]);
+
+                Ptr<PipelineFetcher> fetcher = CreateObject<PipelineFetcher>();
+                fetcher->Configure(blobName, PipelineFetcher::Naming::Segment, 0, segments - 1, fetchCc, 2,
+                                   [this, g](const PipelineFetcher&) { OnBlobFetched(g); });
+                fetcher->SetPayload(payloadSize, segmentSize);
+                fetcher->SetStartTime(Seconds(0));
+                allNodes.node[consumer]->AddApplication(fetcher);
+                blobFetches.push_back({g, consumer, producer, fetcher});
+                grp.pendingBlobs++;
+            }
+        }
+        if (grp.pendingBlobs == 0) {
+            // Um único Point não tem blobs a obter: a sincronização completa coincide com a do estado
+            grp.fullSyncTime = Simulator::Now().GetSeconds();
+            return;
+        }
+
+        pendingBlobFetches++;
+        std::cout << "[FETCH] " << grp.prefix << ": " << grp.pendingBlobs << " blobs de " << payloadSize
+                  << " bytes em segmentos de " << segmentSize << " (" << CongestionControlName(fetchCc) << ")" << std::endl;
+        // Limite de segurança para transferências que nunca terminem
+        ExtendDeadline(Simulator::Now().GetSeconds() + 120.0);
+    }
+
+    void OnBlobFetched(uint32_t g) {
+        SyncPoint& grp = groups[g];
+        if (--grp.pendingBlobs > 0) return;
+        grp.fullSyncTime = Simulator::Now().GetSeconds();
+        std::cout << "[FETCH] " << grp.prefix << " sincronização completa (blobs) em "
+                  << (grp.fullSyncTime - grp.syncStartTime) << "s" << std::endl;
+        pendingBlobFetches--;
+        if (convergenceReported && pendingCatchUps <= 0 && pendingBlobFetches <= 0) FinishRun();
+    }
+
+    // Débito por transferência (blob_fetch.csv), por ligação (blob_links.csv) e uma linha
+    // agregada em payload_sync.csv para comparar payloadSize, dropRate e algoritmo.
+    void WriteBlobReport() const {
+        if (blobFetches.empty()) return;
+        std::ofstream ofs("blob_fetch.csv");
+        if (!ofs.is_open()) {
+            std::cerr << "[METRICS] Falha ao abrir blob_fetch.csv para escrita" << std::endl;
+            return;
+        }
+        ofs << "group,consumer,producer,segments,bytes,start,end,latency,interests,retransmissions,"
+               "windowDecreases,maxCwnd,goodputKbps\n";
+        double firstStart = std::numeric_limits<double>::max();
+        double lastEnd = 0.0;
+        double goodputSum = 0.0;
+        uint64_t retransmissions = 0;
+        size_t complete = 0;
+        for (const auto &bf : blobFetches) {
+            const PipelineFetcher& f = *bf.fetcher;
+            bool done = f.endTime >= 0;
+            ofs << groups[bf.group].prefix << "," << allNodes.Name(bf.consumer) << "," << allNodes.Name(bf.producer)
+                << "," << f.Count() << "," << f.bytesReceived << "," << f.startTime << "," << f.endTime << ","
+                << (done ? f.endTime - f.startTime : -1.0) << "," << f.interestsSent << "," << f.retransmissions << ","
+                << f.cc.decreases << "," << f.cc.maxCwnd << "," << f.GoodputKbps() << "\n";
+            firstStart = std::min(firstStart, f.startTime);
+            lastEnd = std::max(lastEnd, done ? f.endTime : Simulator::Now().GetSeconds());
+            goodputSum += f.GoodputKbps();
+            retransmissions += f.retransmissions;
+            if (done) complete++;
+        }
+        ofs.close();
+
+        double duration = lastEnd - firstStart;
+        std::ofstream links("blob_links.csv");
+        if (links.is_open()) {
+            links << "node,faceId,remote,bytes,goodputMbps\n";
+            for (const auto &entry : blobLinkBytes) {
+                uint32_t cell = entry.first.first;
+                links << "/" << cell / kGridSize << "-" << cell % kGridSize << "," << entry.first.second << ","
+                      << entry.second.first << "," << entry.second.second << ","
+                      << (duration > 0 ? entry.second.second * 8.0 / duration / 1e6 : 0.0) << "\n";
+            }
+        }
+
+        // Grupos sem Points convergem na construção e não participam nas transferências
+        double timeToFullSync = 0.0;
+        for (const auto &grp : groups) {
+            if (grp.pointCount == 0) continue;
+            if (grp.fullSyncTime < 0) {
+                timeToFullSync = -1.0;
+                break;
+            }
+            timeToFullSync = std::max(timeToFullSync, grp.fullSyncTime - grp.syncStartTime);
+        }
+        double meanGoodput = goodputSum / blobFetches.size();
+
+        const std::string summary = "payload_sync.csv";
+        AppendCsvRow(summary, "cc,payloadSize,segmentSize,dropRate,runId,fetches,complete,timeToFullSync,"
+                              "meanGoodputKbps,retransmissions",
+                     CongestionControlName(fetchCc), payloadSize, segmentSize, dropRate, RngSeedManager::GetRun(),
+                     blobFetches.size(), complete, timeToFullSync, meanGoodput, retransmissions);
+
+        std::cout << "[FETCH] " << complete << "/" << blobFetches.size() << " blobs obtidos, goodput médio="
+                  << meanGoodput << " kbps, retx=" << retransmissions << ", sincronização completa="
+                  << timeToFullSync << "s" << std::endl;
+        std::cout << "[METRICS] Transferências segmentadas escritas em blob_fetch.csv, blob_links.csv e "
+                  << summary << std::endl;
+    }
+
+    // Latência e débito de cada recuperação face ao tamanho do gap (catchup.csv).
+    void WriteCatchUpReport() const {
+        if (catchUps.empty()) return;
+        std::ofstream ofs("catchup.csv");
+        if (!ofs.is_open()) {
+            std::cerr << "[METRICS] Falha ao abrir catchup.csv para escrita" << std::endl;
+            return;
+        }
+        ofs << "node,gap,start,end,latency,received,interests,retransmissions,bytes,goodputKbps\n";
+        for (const auto &entry : catchUps) {
+            const PipelineFetcher& f = *entry.second;
+            bool complete = f.endTime >= 0;
+            double latency = complete ? f.endTime - f.startTime : -1.0;
+            ofs << allNodes.Name(entry.first) << "," << f.Count() << "," << f.startTime << "," << f.endTime << ","
+                << latency << "," << f.received << "," << f.interestsSent << "," << f.retransmissions << ","
+                << f.bytesReceived << "," << f.GoodputKbps() << "\n";
+            std::cout << "[CHURN] " << allNodes.Name(entry.first) << " gap=" << f.Count()
+                      << (complete ? " latência=" + std::to_string(latency) + "s" : std::string(" INCOMPLETA"))
+                      << " retx=" << f.retransmissions << std::endl;
+        }
+        ofs.close();
+        std::cout << "[METRICS] Recuperações de estado escritas em catchup.csv" << std::endl;
+    }
+
+    // Constrói as vistas CSR grupo->células e célula->grupos a partir dos pares (grupo, célula).
+    void BuildMembership(std::vector<std::pair<uint32_t, uint32_t>>& membership) {
+        std::sort(membership.begin(), membership.end());
+        groupMembers.clear();
+        groupMembers.reserve(membership.size());
+        for (size_t k = 0; k < membership.size(); ++k) {
+            uint32_t g = membership[k].first;
+            uint32_t cell = membership[k].second;
+            if (k == 0 || membership[k - 1].first != g) groups[g].memberBegin = groupMembers.size();
+            groupMembers.push_back(cell);
+            groups[g].memberEnd = groupMembers.size();
+            if (IsPointCoord(cell / kGridSize, cell % kGridSize)) groups[g].pointCount++;
+        }
+        memberVersion.assign(groupMembers.size(), 0);
+        memberSynced.Resize(groupMembers.size());
+
+        cellGroupOffsets.assign(kGridSize * kGridSize + 1, 0);
+        for (const auto &gc : membership) cellGroupOffsets[gc.second + 1]++;
+        for (size_t c = 1; c < cellGroupOffsets.size(); ++c) cellGroupOffsets[c] += cellGroupOffsets[c - 1];
+        cellGroups.assign(membership.size(), 0);
+        std::vector<uint32_t> cursor(cellGroupOffsets.begin(), cellGroupOffsets.end() - 1);
+        for (const auto &gc : membership) cellGroups[cursor[gc.second]++] = gc.first;
+
+        // Grupos sem Points não têm nada a convergir
+        for (auto &grp : groups) {
+            if (grp.pointCount == 0) {
+                grp.converged = true;
+                groupsConverged++;
+            }
+        }
+    }
+
+    void ComputeReferenceVersions() {
+        for (auto &grp : groups) {
+            uint64_t maxPointVersion = 0;
+            for (uint32_t m = grp.memberBegin; m < grp.memberEnd; ++m) {
+                int idx = nodeIndexByCell[groupMembers[m]];
+                if (idx >= 0 && allNodes.isPoint.Test(idx) && memberVersion[m] > maxPointVersion) {
+                    maxPointVersion = memberVersion[m];
+                    grp.nodeWithLatestData = idx;
+                }
+            }
+            grp.finalReferenceVersion = maxPointVersion;
+
+            if (grp.nodeWithLatestData >= 0) {
+                std::cout << allNodes.Name(grp.nodeWithLatestData) << " detém a versão de referência mais alta ("
+                          << maxPointVersion << ") entre os " << grp.pointCount << " Points de "
+                          << grp.prefix << "." << std::endl;
+            }
+        }
+    }
+
+    // Posição da célula em groupMembers dentro da fatia do grupo g, ou -1 se não for membro.
+    int MemberSlot(uint32_t g, uint32_t cell) const {
+        const SyncPoint& grp = groups[g];
+        auto end = groupMembers.begin() + grp.memberEnd;
+        auto it = std::lower_bound(groupMembers.begin() + grp.memberBegin, end, cell);
+        return it != end && *it == cell ? static_cast<int>(it - groupMembers.begin()) : -1;
+    }
+
+    bool IsMember(uint32_t g, uint32_t cell) const { return MemberSlot(g, cell) >= 0; }
+
+    // Identifica o grupo pelo componente a seguir a "/ndn/svs" (em qualquer posição do nome,
+    // para abranger tanto os Sync Interests como os nomes de dados prefixados pelo nó).
+    int GroupOf(const ::ndn::Name& name) const {
+        static const ::ndn::name::Component ndnComp("ndn");
+        static const ::ndn::name::Component svsComp("svs");
+        for (size_t i = 0; i + 1 < name.size(); ++i) {
+            if (name.get(i) != ndnComp || name.get(i + 1) != svsComp) continue;
+            if (groups.size() == 1) return 0;
+            if (i + 2 >= name.size()) return -1;
+            const auto& comp = name.get(i + 2);
+            const uint8_t* v = comp.value();
+            size_t len = comp.value_size();
+            if (len < 2 || v[0] != 'g') return -1;
+            int g = 0;
+            for (size_t k = 1; k < len; ++k) {
+                if (v[k] < '0' || v[k] > '9') return -1;
+                g = g * 10 + (v[k] - '0');
+            }
+            return g < static_cast<int>(groups.size()) ? g : -1;
+        }
+        return -1;
+    }
+
+    void CountGroupPacket(int cell, const ::ndn::Name& name, size_t size, bool isInterest) {
+        int g = GroupOf(name);
+        if (g < 0) return;
+        SyncPoint& grp = groups[g];
+        if (isInterest) {
+            grp.interests++;
+            if (!IsMember(g, cell)) grp.foreignInterests++;
+        } else {
+            grp.data++;
+        }
+        grp.bytes += size;
+    }
+
+    static void TraceOutInterest(OptimizedSyncMobilityManager* self, int cell,
+                                 const ::ndn::Interest& interest, const nfd::Face& face) {
+        static const ::ndn::Name svsPrefix("/ndn/svs");
+        if (svsPrefix.isPrefixOf(interest.getName())) self->svsInterests++;
+        self->CountGroupPacket(cell, interest.getName(), interest.wireEncode().size(), true);
+    }
+
+    static void TraceOutData(OptimizedSyncMobilityManager* self, int cell,
+                             const ::ndn::Data& data, const nfd::Face& face) {
+        self->CountGroupPacket(cell, data.getName(), data.wireEncode().size(), false);
+
+        static const ::ndn::name::Component blobComponent("blob");
+        if (data.getName().size() > 1 && data.getName().get(1) == blobComponent &&
+            face.getScope() != ::ndn::nfd::FACE_SCOPE_LOCAL) {
+            auto &link = self->blobLinkBytes[{cell, face.getId()}];
+            if (link.first.empty()) link.first = face.getRemoteUri().toString();
+            link.second += data.getContent().value_size();
+        }
+    }
+
+    static void TraceOutNack(OptimizedSyncMobilityManager* self, const ::ndn::lp::Nack& nack, const nfd::Face& face) {
+        if (nack.getReason() == ::ndn::lp::NackReason::DUPLICATE) self->duplicateNacks++;
+    }
+
+    // Escreve o detalhe por grupo (sync_groups.csv) e acrescenta uma linha agregada a
+    // sync_groups_summary.csv, para comparar execuções com K crescente.
+    void WriteGroupReport() const {
+        double now = Simulator::Now().GetSeconds();
+        std::ofstream ofs("sync_groups.csv");
+        if (!ofs.is_open()) {
+            std::cerr << "[METRICS] Falha ao abrir sync_groups.csv para escrita" << std::endl;
+            return;
+        }
+        ofs << "group,prefix,rendezvousRow,rendezvousCol,members,points,start,end,duration,"
+               "interests,data,bytes,dataPerSec,foreignInterestRatio\n";
+
+        uint64_t totalInterests = 0, totalData = 0, totalForeign = 0;
+        double sumDuration = 0.0;
+        size_t convergedGroups = 0;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            const SyncPoint& grp = groups[g];
+            double duration = grp.pointCount == 0 ? 0.0 : grp.converged ? grp.syncEndTime - grp.syncStartTime : -1.0;
+            double foreignRatio = grp.interests ? double(grp.foreignInterests) / grp.interests : 0.0;
+            ofs << g << "," << grp.prefix << "," << grp.row << "," << grp.col << ","
+                << (grp.memberEnd - grp.memberBegin) << "," << grp.pointCount << ","
+                << grp.syncStartTime << "," << grp.syncEndTime << "," << duration << ","
+                << grp.interests << "," << grp.data << "," << grp.bytes << ","
+                << (now > 0 ? grp.data / now : 0.0) << "," << foreignRatio << "\n";
+            totalInterests += grp.interests;
+            totalData += grp.data;
+            totalForeign += grp.foreignInterests;
+            if (grp.converged) {
+                sumDuration += duration;
+                convergedGroups++;
+            }
+        }
+        ofs.close();
+
+        const char* summaryFile = "sync_groups_summary.csv";
+        if (!AppendCsvRow(summaryFile, "groups,converged,totalDuration,meanGroupDuration,interests,data,dataPerSec,"
+                                       "foreignInterestRatio",
+                          groups.size(), convergedGroups, metrics.totalSyncDuration,
+                          convergedGroups ? sumDuration / convergedGroups : -1.0, totalInterests,
+                          totalData, now > 0 ? totalData / now : 0.0,
+                          totalInterests ? double(totalForeign) / totalInterests : 0.0)) {
+            return;
+        }
+        std::cout << "[METRICS] Métricas por grupo escritas em sync_groups.csv e " << summaryFile << std::endl;
+    }
 };
 
 
@@ -288,6 +1463,19 @@ int main_ndn(int argc, char* argv[]) {
     int nRandom = 3;
     double dropRate = 0.01;
     bool frag = false;
+    int nGroups = 1;
+    double groupOverlap = 0.0;
+    std::string churn = "";
+    int catchUpWindow = 8;
+    int catchUpPayload = 1024;
+    int routeThreads = 0;
+    bool routeCheck = false;
+    std::string svsForwarding = "multicast";
+    int gossipFanout = 2;
+    int payloadSize = 0;
+    int segmentSize = 1024;
+    std::string fetchCc = "aimd";
+    std::string syncApp = "chat";
 
 
     CommandLine cmd;
@@ -297,7 +1485,35 @@ int main_ndn(int argc, char* argv[]) {
     cmd.AddValue("nRandom", "Numero de entradas aleatorias a sincronizar", nRandom);
     cmd.AddValue("dropRate", "Taxa de erro de pacotes", dropRate);
     cmd.AddValue("frag", "Ativar fragmentacao (MTU 1280)", frag);
+    cmd.AddValue("nGroups", "Numero de grupos de sincronizacao independentes", nGroups);
+    cmd.AddValue("groupOverlap", "Probabilidade de um no pertencer a um segundo grupo", groupOverlap);
+    cmd.AddValue("churn", "Eventos de churn: <join|leave|crash|rejoin>:<row>-<col>@<t>,...", churn);
+    cmd.AddValue("catchUpWindow", "Interests pendentes na recuperacao de estado", catchUpWindow);
+    cmd.AddValue("catchUpPayload", "Tamanho (bytes) de cada publicacao recuperada ou obtida pela GroupSyncApp", catchUpPayload);
+    cmd.AddValue("syncApp", "Aplicacao de sincronizacao: chat ou group (GroupSyncApp, com prefixo por grupo)", syncApp);
+    cmd.AddValue("svsForwarding", "Encaminhamento de /ndn/svs: multicast, tree ou gossip", svsForwarding);
+    cmd.AddValue("gossipFanout", "Faces por Interest reencaminhado no modo gossip", gossipFanout);
+    cmd.AddValue("payloadSize", "Tamanho (bytes) das publicacoes segmentadas (0 = desativado)", payloadSize);
+    cmd.AddValue("segmentSize", "Tamanho (bytes) de cada segmento", segmentSize);
+    cmd.AddValue("fetchCc", "Controlo de congestionamento do pipeline: aimd ou cubic", fetchCc);
+    cmd.AddValue("routeThreads", "Threads no calculo de rotas (0 = GlobalRoutingHelper, >=1 = CSR paralelo)", routeThreads);
+    cmd.AddValue("routeCheck", "Compara as rotas CSR com as FIB do GlobalRoutingHelper (mantém as rotas legacy)", routeCheck);
     cmd.Parse(argc, argv);
+    if (syncApp != "chat" && syncApp != "group") {
+        std::cerr << "[GROUPS] Aplicação de sincronização desconhecida '" << syncApp << "', a usar chat" << std::endl;
+        syncApp = "chat";
+    }
+    // O Chat usa sempre /ndn/svs: vários grupos requerem a GroupSyncApp. Para comparar K
+    // crescente com a mesma aplicação, corra também K=1 com --syncApp=group.
+    if (nGroups > 1 && syncApp == "chat") {
+        std::cout << "[GROUPS] --nGroups=" << nGroups << ": o Chat não separa grupos, a usar --syncApp=group" << std::endl;
+        syncApp = "group";
+    }
+    bool groupApp = syncApp == "group";
+    std::vector<ChurnEvent> churnEvents = ParseChurnEvents(churn);
+
+    MemoryReport memory;
+    memory.Mark("start");
 
     Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable>();
     uv->SetStream(50);
@@ -325,7 +1541,7 @@ int main_ndn(int argc, char* argv[]) {
     PointToPointHelper p2p;
     PointToPointGridHelper grid(nRows, nCols, p2p);
     grid.BoundingBox(50, 50, 550, 550);
-
+    memory.Mark("topology");
 
     ndn::StackHelper ndnHelper;
     ndnHelper.InstallAll();
@@ -334,67 +1550,117 @@ int main_ndn(int argc, char* argv[]) {
     ndn::AppDelayTracer::InstallAll("AppDelayTracer.txt");
     ndn::CsTracer::InstallAll("CsTracer.txt", Seconds(1.0));
 
-    ndn::StrategyChoiceHelper::InstallAll("/ndn/svs", "/localhost/nfd/strategy/multicast");
+    SvsForwardingMode svsMode = ParseSvsForwardingMode(svsForwarding);
+    InstallSvsStrategy(svsMode, gossipFanout);
     ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/best-route");
     ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
     ndnGlobalRoutingHelper.InstallAll();
+    memory.Mark("ndnStack");
 
 
-    OptimizedSyncMobilityManager* mobilityMgr = new OptimizedSyncMobilityManager();
+    OptimizedSyncMobilityManager* mobilityMgr = new OptimizedSyncMobilityManager(nGroups, groupOverlap);
 
 
     for (int row = 0; row < nRows; row++) {
         for (int col = 0; col < nCols; col++) {
             Ptr<Node> node = grid.GetNode(row, col);
             std::string prefix = "/" + std::to_string(row) + "-" + std::to_string(col);
+            mobilityMgr->ConnectGroupTraces(node, row, col);
             
             if (row != 2 || col != 2) {
                 bool isFastPublisher = (fastPublishers.find(prefix) != fastPublishers.end());
 
-                ndn::AppHelper svsHelper("Chat");
+                ndn::AppHelper svsHelper(groupApp ? "ns3::GroupSyncApp" : "Chat");
                 svsHelper.SetPrefix(prefix);
                 svsHelper.SetAttribute("PublishDelayMs",
                                          IntegerValue(isFastPublisher ? interPubMsFast : interPubMsSlow));
                 svsHelper.SetAttribute("NRecent", IntegerValue(nRecent));
                 svsHelper.SetAttribute("NRand", IntegerValue(nRandom));
 
-
-                auto apps = svsHelper.Install(node);
-                apps.Start(Seconds(5.0 + (row * nCols + col) * 0.1));
+                // Com a GroupSyncApp, instala uma aplicação por grupo a que o nó pertence, mais o
+                // Producer das suas publicações nesse grupo (<prefix><grupo>/<seq>).
+                // Com churn, cada sessão (join/rejoin) é uma nova instância da aplicação.
+                std::vector<std::string> groupPrefixes = mobilityMgr->GetGroupPrefixes(row, col);
+                auto sessions = AppSessions(churnEvents, row, col, 5.0 + (row * nCols + col) * 0.1);
+                for (const auto &groupPrefix : groupPrefixes) {
+                    if (groupApp) {
+                        svsHelper.SetAttribute("SyncPrefix", StringValue(groupPrefix));
+                        ndn::AppHelper groupProducer("ns3::ndn::Producer");
+                        groupProducer.SetPrefix(prefix + groupPrefix);
+                        groupProducer.SetAttribute("PayloadSize", StringValue(std::to_string(catchUpPayload)));
+                        groupProducer.Install(node);
+                    }
+                    for (const auto &session : sessions) {
+                        auto apps = svsHelper.Install(node);
+                        apps.Start(Seconds(session.first));
+                        if (session.second >= 0) apps.Stop(Seconds(session.second));
+                    }
+                }
                 ndnGlobalRoutingHelper.AddOrigins(prefix, node);
 
+                // Fonte das publicações recuperadas pelos nós que (re)entram
+                if (!churnEvents.empty()) {
+                    ndn::AppHelper catchUpProducer("ns3::ndn::Producer");
+                    catchUpProducer.SetPrefix(prefix + "/catchup");
+                    catchUpProducer.SetAttribute("PayloadSize", StringValue(std::to_string(catchUpPayload)));
+                    catchUpProducer.Install(node);
+                }
+
+                // Segmentos das publicações grandes (/<prefix>/blob/<versão>/<seg>)
+                if (payloadSize > 0) {
+                    ndn::AppHelper blobProducer("ns3::ndn::Producer");
+                    blobProducer.SetPrefix(prefix + "/blob");
+                    blobProducer.SetAttribute("PayloadSize", StringValue(std::to_string(segmentSize)));
+                    blobProducer.Install(node);
+                }
+
                 mobilityMgr->SetupOptimizedMobility(node, row, col, isFastPublisher);
             }
         }
     }
 
 
-    ndn::GlobalRoutingHelper::CalculateRoutes();
+    mobilityMgr->InstallMobility();
+    if (payloadSize > 0) {
+        mobilityMgr->ConfigureBlobs(payloadSize, segmentSize, ParseCongestionControl(fetchCc), dropRate);
+    }
+    if (!churnEvents.empty()) {
+        mobilityMgr->ScheduleChurn(churnEvents, interPubMsFast, interPubMsSlow, catchUpWindow, 5.0);
+    }
+
+    // Rotas globais: caminho original ou cálculo CSR paralelo com fusão single-threaded
+    ParallelRouteCalculator::Run(routeThreads, routeCheck);
 
     for (int row = 0; row < nRows; row++) {
         for (int col = 0; col < nCols; col++) {
             Ptr<Node> participant = grid.GetNode(row, col);
-            if (row > 0) {
+            if (row > 0 && IsSvsRouteEnabled(svsMode, row, col, row - 1, col, nCols)) {
                 ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row - 1, col), 1);
             }
-            if (col > 0) {
+            if (col > 0 && IsSvsRouteEnabled(svsMode, row, col, row, col - 1, nCols)) {
                 ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row, col - 1), 1);
             }
-            if (row < nRows - 1) {
+            if (row < nRows - 1 && IsSvsRouteEnabled(svsMode, row, col, row + 1, col, nCols)) {
                 ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row + 1, col), 1);
             }
-            if (col < nCols - 1) {
+            if (col < nCols - 1 && IsSvsRouteEnabled(svsMode, row, col, row, col + 1, nCols)) {
                 ndn::FibHelper::AddRoute(participant, "/ndn/svs", grid.GetNode(row, col + 1), 1);
             }
         }
     }
 
 
+    memory.Mark("setup");
     std::cout << "=== A INICIAR SIMULAÇÃO ===" << std::endl;
     
 
 
+
     Simulator::Run();
+    memory.Mark("end");
+    memory.WriteFile(mobilityMgr->NodeCount(), mobilityMgr->MemoryBytes());
+    AppendSvsForwardingReport(svsMode, mobilityMgr->NodeCount(), mobilityMgr->SvsInterests(),
+                              mobilityMgr->DuplicateNacks());
     Simulator::Destroy();
 
     delete mobilityMgr;
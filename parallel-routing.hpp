@@ -0,0 +1,315 @@
+#ifndef PARALLEL_ROUTING_HPP
+#define PARALLEL_ROUTING_HPP
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+#include "sim-common.hpp"
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+
+// -------------------- Parallel Route Calculator --------------------
+// Alternativa a ndn::GlobalRoutingHelper::CalculateRoutes() para topologias grandes:
+//  1. constrói uma única vez um grafo CSR imutável a partir dos GlobalRouter, com as
+//     arestas de cada nó pela ordem de GetIncidencies();
+//  2. corre, numa pool de threads, o mesmo boost::dijkstra_shortest_paths que o
+//     GlobalRoutingHelper corre por nó (mesma combinação e comparação de pesos), cada
+//     thread com os seus buffers e a escrever apenas no slot de resultados do seu nó;
+//  3. instala as entradas FIB numa fusão single-threaded, pela ordem do caminho legacy.
+// Como o algoritmo, a ordem das arestas e a ordem de instalação são as do legacy, os
+// desempates entre caminhos de igual custo também o são: as FIB resultantes são
+// idênticas às do GlobalRoutingHelper para qualquer número de threads.
+class ParallelRouteCalculator {
+public:
+    struct Timings {
+        std::string mode;
+        unsigned threads{0};
+        size_t nodes{0};
+        size_t origins{0};
+        size_t prefixes{0};
+        size_t routes{0};
+        double buildMs{0.0};
+        double computeMs{0.0};
+        double mergeMs{0.0};
+
+        double TotalMs() const { return buildMs + computeMs + mergeMs; }
+    };
+
+    static Timings CalculateRoutes(unsigned threads) {
+        Timings t;
+        RouteGraph graph;
+        std::vector<std::vector<RouteEntry>> results;
+        Compute(threads, t, graph, results);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t v = 0; v < graph.nodes.size(); ++v) {
+            for (const auto &r : results[v]) {
+                for (uint32_t p = graph.prefixOffsets[r.origin]; p < graph.prefixOffsets[r.origin + 1]; ++p) {
+                    ndn::FibHelper::AddRoute(graph.nodes[v], graph.prefixes[p], graph.faces[r.edge], r.metric);
+                    t.routes++;
+                }
+            }
+        }
+        t.mergeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return t;
+    }
+
+    // Caminho original (GlobalRoutingHelper), cronometrado para comparação.
+    static Timings CalculateRoutesLegacy() {
+        auto t0 = std::chrono::steady_clock::now();
+        ndn::GlobalRoutingHelper::CalculateRoutes();
+        Timings t;
+        t.mode = "legacy";
+        t.threads = 1;
+        t.nodes = NodeList::GetNNodes();
+        t.computeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        return t;
+    }
+
+    struct CheckResult {
+        size_t pairs{0};       // pares (nó, prefixo) com rota em pelo menos um dos caminhos
+        size_t exact{0};       // mesmas faces e custos
+        size_t ties{0};        // faces diferentes mas com o mesmo custo mínimo (desempate divergente)
+        size_t mismatches{0};  // custo mínimo diferente ou rota ausente num dos lados
+    };
+
+    // Calcula as rotas CSR sem as instalar, instala as do GlobalRoutingHelper e compara as
+    // duas FIB por (nó, prefixo). Com o mesmo desempate dos dois lados, o esperado é
+    // iguais == pares, sem empates nem divergentes. A simulação continua com as rotas do
+    // GlobalRoutingHelper.
+    static CheckResult CheckAgainstLegacy(unsigned threads, const std::string& filename = "routing_check.csv") {
+        Timings t;
+        RouteGraph graph;
+        std::vector<std::vector<RouteEntry>> results;
+        Compute(threads, t, graph, results);
+
+        using NextHops = std::map<uint64_t, uint64_t>;  // face id -> custo
+        std::vector<std::map<::ndn::Name, NextHops>> expected(graph.nodes.size());
+        for (size_t v = 0; v < graph.nodes.size(); ++v) {
+            for (const auto &r : results[v]) {
+                for (uint32_t p = graph.prefixOffsets[r.origin]; p < graph.prefixOffsets[r.origin + 1]; ++p) {
+                    expected[v][graph.prefixes[p]][graph.faces[r.edge]->getId()] = r.metric;
+                }
+            }
+        }
+
+        Report(CalculateRoutesLegacy());
+
+        std::set<uint64_t> networkFaces;
+        for (const auto &face : graph.faces) networkFaces.insert(face->getId());
+        std::set<::ndn::Name> prefixes(graph.prefixes.begin(), graph.prefixes.end());
+
+        auto minCost = [](const NextHops& hops) {
+            uint64_t best = std::numeric_limits<uint64_t>::max();
+            for (const auto &h : hops) best = std::min(best, h.second);
+            return best;
+        };
+
+        CheckResult c;
+        for (uint32_t v = 0; v < graph.nodes.size(); ++v) {
+            const nfd::Fib& fib = graph.nodes[v]->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+            for (const auto &prefix : prefixes) {
+                NextHops legacy;
+                if (const nfd::fib::Entry* entry = fib.findExactMatch(prefix)) {
+                    // Só as faces de rede: a face da aplicação na origem não vem do cálculo de rotas.
+                    for (const auto &hop : entry->getNextHops()) {
+                        if (networkFaces.count(hop.getFace().getId())) legacy[hop.getFace().getId()] = hop.getCost();
+                    }
+                }
+                auto it = expected[v].find(prefix);
+                const NextHops csr = it != expected[v].end() ? it->second : NextHops{};
+                if (legacy.empty() && csr.empty()) continue;
+
+                c.pairs++;
+                if (legacy == csr) c.exact++;
+                else if (!legacy.empty() && !csr.empty() && minCost(legacy) == minCost(csr)) c.ties++;
+                else c.mismatches++;
+            }
+        }
+
+        std::cout << "[ROUTING] verificação CSR vs GlobalRoutingHelper: pares=" << c.pairs << " iguais=" << c.exact
+                  << " empates=" << c.ties << " divergentes=" << c.mismatches << std::endl;
+
+        AppendCsvRow(filename, "threads,nodes,origins,prefixes,pairs,exact,ties,mismatches", t.threads, t.nodes,
+                     t.origins, t.prefixes, c.pairs, c.exact, c.ties, c.mismatches);
+        return c;
+    }
+
+    // Ponto de entrada dos cenários: 0 = GlobalRoutingHelper, >=1 = CSR paralelo; com check,
+    // compara os dois caminhos e fica com as rotas do GlobalRoutingHelper.
+    static void Run(int threads, bool check) {
+        if (check) CheckAgainstLegacy(std::max(threads, 1));
+        else Report(threads > 0 ? CalculateRoutes(threads) : CalculateRoutesLegacy());
+    }
+
+    static void Report(const Timings& t, const std::string& filename = "routing_times.csv") {
+        std::cout << "[ROUTING] modo=" << t.mode << " threads=" << t.threads << " nós=" << t.nodes
+                  << " origens=" << t.origins << " prefixos=" << t.prefixes << " rotas=" << t.routes
+                  << " build=" << t.buildMs << "ms compute=" << t.computeMs
+                  << "ms merge=" << t.mergeMs << "ms total=" << t.TotalMs() << "ms" << std::endl;
+
+        AppendCsvRow(filename, "mode,threads,nodes,origins,prefixes,routes,buildMs,computeMs,mergeMs,totalMs", t.mode,
+                     t.threads, t.nodes, t.origins, t.prefixes, t.routes, t.buildMs, t.computeMs, t.mergeMs,
+                     t.TotalMs());
+    }
+
+private:
+    struct RouteEntry {
+        uint32_t origin;  // índice em originNodes
+        uint32_t edge;    // aresta (face) de saída do primeiro salto
+        uint32_t metric;
+    };
+
+    using CsrGraph = boost::compressed_sparse_row_graph<boost::directedS, boost::no_property, boost::no_property,
+                                                        boost::no_property, uint32_t, uint32_t>;
+
+    struct RouteGraph {
+        std::vector<Ptr<Node>> nodes;
+        CsrGraph csr;                       // arestas de saída do nó i pela ordem de GetIncidencies()
+        std::vector<uint32_t> weights;      // por índice de aresta
+        std::vector<std::shared_ptr<nfd::Face>> faces;
+        std::vector<uint32_t> originNodes;  // nós com prefixos locais, pela ordem do DistancesMap legacy
+        std::vector<uint32_t> prefixOffsets;
+        std::vector<::ndn::Name> prefixes;
+    };
+
+    // Distância do GlobalRoutingHelper sem o atraso (que não entra na comparação nem na FIB):
+    // aresta do primeiro salto (-1 na origem do Dijkstra) e custo acumulado.
+    struct Hop {
+        int32_t edge;
+        uint32_t metric;
+    };
+
+    // Equivalentes a boost::WeightCombine e boost::WeightCompare do ndnSIM: a face do primeiro
+    // salto é herdada ao longo do caminho e só o custo é comparado.
+    struct HopCombine {
+        const std::vector<uint32_t>* weights;
+
+        Hop operator()(const Hop& d, uint32_t e) const {
+            return {d.edge < 0 ? static_cast<int32_t>(e) : d.edge, d.metric + (*weights)[e]};
+        }
+    };
+
+    struct HopCompare {
+        bool operator()(const Hop& a, const Hop& b) const { return a.metric < b.metric; }
+    };
+
+    // Constrói o grafo e corre os Dijkstra na pool, sem tocar nas FIB.
+    static void Compute(unsigned threads, Timings& t, RouteGraph& graph,
+                        std::vector<std::vector<RouteEntry>>& results) {
+        using Clock = std::chrono::steady_clock;
+        t.mode = "csr";
+        t.threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+        auto t0 = Clock::now();
+        graph = BuildGraph();
+        auto t1 = Clock::now();
+
+        results.assign(graph.nodes.size(), {});
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            std::vector<Hop> dist;
+            for (size_t v = next++; v < graph.nodes.size(); v = next++) {
+                ComputeSource(graph, v, dist, results[v]);
+            }
+        };
+        unsigned nWorkers = std::min<size_t>(t.threads, std::max<size_t>(graph.nodes.size(), 1));
+        if (nWorkers <= 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            for (unsigned i = 0; i < nWorkers; ++i) pool.emplace_back(worker);
+            for (auto &th : pool) th.join();
+        }
+        auto t2 = Clock::now();
+
+        t.nodes = graph.nodes.size();
+        t.origins = graph.originNodes.size();
+        t.prefixes = graph.prefixes.size();
+        t.buildMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        t.computeMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+
+    static RouteGraph BuildGraph() {
+        RouteGraph g;
+        std::vector<int32_t> indexById(NodeList::GetNNodes(), -1);
+        std::vector<Ptr<ndn::GlobalRouter>> routers;
+        for (NodeList::Iterator it = NodeList::Begin(); it != NodeList::End(); ++it) {
+            Ptr<ndn::GlobalRouter> gr = (*it)->GetObject<ndn::GlobalRouter>();
+            if (!gr) continue;
+            indexById[(*it)->GetId()] = g.nodes.size();
+            g.nodes.push_back(*it);
+            routers.push_back(gr);
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        for (size_t i = 0; i < routers.size(); ++i) {
+            for (const auto &inc : routers[i]->GetIncidencies()) {
+                Ptr<ndn::GlobalRouter> neighbor = std::get<2>(inc);
+                std::shared_ptr<nfd::Face> face = std::get<1>(inc);
+                if (!neighbor || !face) continue;
+                int32_t j = indexById[neighbor->GetObject<Node>()->GetId()];
+                if (j < 0) continue;
+                edges.emplace_back(i, j);
+                // O EdgeWeights do ndnSIM trunca a métrica a 16 bits; fazemos o mesmo.
+                g.weights.push_back(static_cast<uint16_t>(face->getMetric()));
+                g.faces.push_back(face);
+            }
+        }
+        g.csr = CsrGraph(boost::edges_are_sorted, edges.begin(), edges.end(), routers.size());
+
+        // O GlobalRoutingHelper percorre as distâncias num std::map<Ptr<GlobalRouter>, ...>:
+        // as origens ficam pela ordem dos ponteiros para instalar as rotas na mesma ordem.
+        for (size_t i = 0; i < routers.size(); ++i) {
+            if (!routers[i]->GetLocalPrefixes().empty()) g.originNodes.push_back(i);
+        }
+        std::sort(g.originNodes.begin(), g.originNodes.end(),
+                  [&](uint32_t a, uint32_t b) { return routers[a] < routers[b]; });
+        g.prefixOffsets.push_back(0);
+        for (uint32_t i : g.originNodes) {
+            for (const auto &prefix : routers[i]->GetLocalPrefixes()) g.prefixes.push_back(*prefix);
+            g.prefixOffsets.push_back(g.prefixes.size());
+        }
+        return g;
+    }
+
+    // Dijkstra a partir de source sobre as arestas de saída, como o GlobalRoutingHelper faz
+    // para cada nó: guarda a face do primeiro salto e o custo até cada origem alcançável.
+    static void ComputeSource(const RouteGraph& g, uint32_t source, std::vector<Hop>& dist,
+                              std::vector<RouteEntry>& out) {
+        dist.assign(g.nodes.size(), Hop{-1, std::numeric_limits<uint32_t>::max()});
+        boost::dijkstra_shortest_paths(
+          g.csr, source,
+          boost::distance_map(boost::make_iterator_property_map(dist.begin(), boost::get(boost::vertex_index, g.csr)))
+            .weight_map(boost::get(boost::edge_index, g.csr))
+            .distance_inf(Hop{-1, std::numeric_limits<uint32_t>::max()})
+            .distance_zero(Hop{-1, 0})
+            .distance_compare(HopCompare())
+            .distance_combine(HopCombine{&g.weights}));
+
+        out.clear();
+        for (uint32_t k = 0; k < g.originNodes.size(); ++k) {
+            const Hop& d = dist[g.originNodes[k]];
+            if (g.originNodes[k] == source || d.edge < 0) continue;
+            out.push_back({k, static_cast<uint32_t>(d.edge), d.metric});
+        }
+    }
+};
+
+} // namespace ns3
+
+#endif // PARALLEL_ROUTING_HPP
@@ -0,0 +1,119 @@
+#ifndef SIM_COMMON_HPP
+#define SIM_COMMON_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+namespace ns3 {
+
+// -------------------- Role Bitset --------------------
+// Bitset compacto para os papéis dos nós (um bit por nó).
+class RoleBitset {
+public:
+    void Resize(size_t n) { words.resize((n + 63) / 64, 0); }
+    void Set(size_t i) { words[i >> 6] |= (uint64_t(1) << (i & 63)); }
+    void Clear(size_t i) { words[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    bool Test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    size_t Count() const {
+        size_t n = 0;
+        for (uint64_t w : words) n += __builtin_popcountll(w);
+        return n;
+    }
+    size_t MemoryBytes() const { return words.capacity() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> words;
+};
+
+// -------------------- CSV Append --------------------
+inline void WriteCsvFields(std::ostream&) {}
+
+template <typename T, typename... Rest>
+void WriteCsvFields(std::ostream& os, const T& first, const Rest&... rest) {
+    os << first;
+    if (sizeof...(rest)) os << ",";
+    WriteCsvFields(os, rest...);
+}
+
+// Acrescenta uma linha a um CSV partilhado entre execuções (cabeçalho só num ficheiro novo),
+// para comparar corridas com parâmetros diferentes no mesmo ficheiro.
+template <typename... Fields>
+bool AppendCsvRow(const std::string& filename, const char* header, const Fields&... fields) {
+    bool writeHeader = !std::ifstream(filename).good();
+    std::ofstream ofs(filename, std::ios::app);
+    if (!ofs.is_open()) {
+        std::cerr << "[METRICS] Falha ao abrir " << filename << " para escrita" << std::endl;
+        return false;
+    }
+    if (writeHeader) ofs << header << "\n";
+    WriteCsvFields(ofs, fields...);
+    ofs << "\n";
+    return true;
+}
+
+// -------------------- Memory Report --------------------
+// RSS atual a partir de /proc/self/statm (barato o suficiente para o relatório periódico).
+static long ReadRssKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pagesTotal = 0, pagesResident = 0;
+    if (!(statm >> pagesTotal >> pagesResident)) return -1;
+    return pagesResident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Campo em kB de /proc/self/status (ex.: "VmHWM:" para o pico de RSS).
+static long ReadStatusKb(const char* field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t len = strlen(field);
+    while (std::getline(status, line)) {
+        if (line.compare(0, len, field) == 0) return atol(line.c_str() + len);
+    }
+    return -1;
+}
+
+// RSS em pontos-chave da configuração, para separar o custo da topologia, da stack
+// ndnSIM e das aplicações da memória ocupada pelo próprio manager.
+struct MemoryReport {
+    std::vector<std::pair<std::string, long>> stages;
+
+    void Mark(const std::string& stage) { stages.emplace_back(stage, ReadRssKb()); }
+
+    void WriteFile(size_t nodeCount, size_t managerBytes, const std::string &filename = "memory_report.json") const {
+        long peakKb = ReadStatusKb("VmHWM:");
+        double perNode = nodeCount ? double(peakKb) / nodeCount : 0.0;
+        double managerPerNode = nodeCount ? double(managerBytes) / nodeCount : 0.0;
+        std::cout << "[MEMORY] pico RSS=" << peakKb << "kB (" << perNode << " kB/nó), manager="
+                  << managerBytes / 1024.0 << "kB (" << managerPerNode << " B/nó)" << std::endl;
+
+        std::ofstream ofs(filename);
+        if (!ofs.is_open()) {
+            std::cerr << "[METRICS] Falha ao abrir " << filename << " para escrita" << std::endl;
+            return;
+        }
+        ofs << "{\n  \"nodes\": " << nodeCount
+            << ",\n  \"peakRssKb\": " << peakKb
+            << ",\n  \"peakRssPerNodeKb\": " << perNode
+            << ",\n  \"managerBytes\": " << managerBytes
+            << ",\n  \"managerBytesPerNode\": " << managerPerNode
+            << ",\n  \"stages\": [\n";
+        for (size_t i = 0; i < stages.size(); ++i) {
+            long delta = i ? stages[i].second - stages[i - 1].second : stages[i].second;
+            ofs << "    {\"stage\": \"" << stages[i].first << "\", \"rssKb\": " << stages[i].second
+                << ", \"deltaKb\": " << delta << "}" << (i + 1 < stages.size() ? "," : "") << "\n";
+        }
+        ofs << "  ]\n}\n";
+        ofs.close();
+        std::cout << "[METRICS] Relatório de memória escrito em " << filename << std::endl;
+    }
+};
+
+} // namespace ns3
+
+#endif // SIM_COMMON_HPP
@@ -0,0 +1,162 @@
+#ifndef SVS_FORWARDING_HPP
+#define SVS_FORWARDING_HPP
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/NFD/daemon/fw/strategy.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/algorithm.hpp"
+#include "sim-common.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+// -------------------- SVS Gossip Strategy --------------------
+// Estratégia para /ndn/svs que substitui o multicast por um gossip probabilístico:
+// Interests gerados localmente seguem para todas as faces (semente), os restantes
+// são reencaminhados para no máximo `fanout` faces escolhidas ao acaso, com peso por
+// face. Um Nack Duplicate indica que a face já recebeu o Interest por outro caminho
+// e reduz o seu peso para metade; cada envio recupera-o aditivamente (AIMD). O
+// trabalho por nó fica limitado a `fanout` envios por Interest, independente da grelha.
+class SvsGossipStrategy : public Strategy {
+public:
+    explicit SvsGossipStrategy(Forwarder& forwarder, const Name& name = getStrategyName())
+        : Strategy(forwarder), m_rand(ns3::CreateObject<ns3::UniformRandomVariable>()) {
+        this->setInstanceName(makeInstanceName(name, getStrategyName()));
+    }
+
+    static const Name& getStrategyName() {
+        static Name strategyName("/localhost/nfd/strategy/svs-gossip/%FD%01");
+        return strategyName;
+    }
+
+    // Fan-out comum a todas as instâncias (configurado pelo cenário antes da instalação)
+    static uint32_t& Fanout() { static uint32_t fanout = 2; return fanout; }
+
+    void afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
+                              const shared_ptr<pit::Entry>& pitEntry) override {
+        if (hasPendingOutRecords(*pitEntry)) return;
+
+        const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+        std::vector<Face*> eligible;
+        for (const auto& nexthop : fibEntry.getNextHops()) {
+            Face& face = nexthop.getFace();
+            if (face.getId() == ingress.face.getId() || wouldViolateScope(ingress.face, interest, face)) continue;
+            eligible.push_back(&face);
+        }
+
+        if (eligible.empty()) {
+            lp::NackHeader nackHeader;
+            nackHeader.setReason(lp::NackReason::NO_ROUTE);
+            this->sendNack(pitEntry, ingress, nackHeader);
+            this->rejectPendingInterest(pitEntry);
+            return;
+        }
+
+        bool isLocal = ingress.face.getScope() == ndn::nfd::FACE_SCOPE_LOCAL;
+        size_t fanout = isLocal ? eligible.size() : std::min<size_t>(std::max<uint32_t>(Fanout(), 1), eligible.size());
+
+        // Seleção ponderada sem reposição
+        for (size_t chosen = 0; chosen < fanout; ++chosen) {
+            double total = 0.0;
+            for (size_t i = chosen; i < eligible.size(); ++i) total += Weight(eligible[i]->getId());
+            double r = m_rand->GetValue(0.0, total);
+            size_t pick = chosen;
+            for (size_t i = chosen; i < eligible.size(); ++i) {
+                r -= Weight(eligible[i]->getId());
+                if (r <= 0) { pick = i; break; }
+                pick = i;
+            }
+            std::swap(eligible[chosen], eligible[pick]);
+
+            Face& outFace = *eligible[chosen];
+            double& w = Weight(outFace.getId());
+            w = std::min(1.0, w + 0.05);
+            this->sendInterest(pitEntry, FaceEndpoint(outFace, 0), interest);
+        }
+    }
+
+    void afterReceiveNack(const FaceEndpoint& ingress, const lp::Nack& nack,
+                          const shared_ptr<pit::Entry>& pitEntry) override {
+        if (nack.getReason() == lp::NackReason::DUPLICATE) {
+            double& w = Weight(ingress.face.getId());
+            w = std::max(0.05, w * 0.5);
+        }
+    }
+
+private:
+    std::unordered_map<FaceId, double> m_weights;
+    ns3::Ptr<ns3::UniformRandomVariable> m_rand;
+
+    double& Weight(FaceId face) {
+        auto it = m_weights.find(face);
+        if (it == m_weights.end()) it = m_weights.emplace(face, 1.0).first;
+        return it->second;
+    }
+};
+
+NFD_REGISTER_STRATEGY(SvsGossipStrategy);
+
+} // namespace fw
+} // namespace nfd
+
+namespace ns3 {
+
+// -------------------- SVS Forwarding Mode --------------------
+// multicast: estratégia multicast com rotas /ndn/svs para os quatro vizinhos (original);
+// tree:      multicast restrito a uma árvore de cobertura com raiz no centro da grelha;
+// gossip:    SvsGossipStrategy sobre as rotas para os quatro vizinhos.
+enum class SvsForwardingMode { Multicast, Tree, Gossip };
+
+static SvsForwardingMode ParseSvsForwardingMode(const std::string& mode) {
+    if (mode == "tree") return SvsForwardingMode::Tree;
+    if (mode == "gossip") return SvsForwardingMode::Gossip;
+    if (mode != "multicast") {
+        std::cerr << "[SVS] Modo de encaminhamento desconhecido '" << mode << "', a usar multicast" << std::endl;
+    }
+    return SvsForwardingMode::Multicast;
+}
+
+static const char* SvsForwardingModeName(SvsForwardingMode mode) {
+    switch (mode) {
+    case SvsForwardingMode::Tree: return "tree";
+    case SvsForwardingMode::Gossip: return "gossip";
+    default: return "multicast";
+    }
+}
+
+static void InstallSvsStrategy(SvsForwardingMode mode, uint32_t fanout) {
+    if (mode == SvsForwardingMode::Gossip) {
+        nfd::fw::SvsGossipStrategy::Fanout() = fanout;
+        ndn::StrategyChoiceHelper::InstallAll<nfd::fw::SvsGossipStrategy>("/ndn/svs");
+    } else {
+        ndn::StrategyChoiceHelper::InstallAll("/ndn/svs", "/localhost/nfd/strategy/multicast");
+    }
+}
+
+// Árvore em "pente" com raiz no centro: a coluna central liga as linhas e cada linha
+// é percorrida horizontalmente. Todos os nós ficam à distância mínima da raiz.
+static bool IsSvsRouteEnabled(SvsForwardingMode mode, int r1, int c1, int r2, int c2, int nCols) {
+    if (mode != SvsForwardingMode::Tree) return true;
+    if (r1 == r2) return true;
+    return c1 == c2 && c1 == nCols / 2;
+}
+
+static void AppendSvsForwardingReport(SvsForwardingMode mode, size_t nodes, uint64_t svsInterests,
+                                      uint64_t duplicateNacks, const std::string& filename = "svs_forwarding.csv") {
+    double perNode = nodes ? double(svsInterests) / nodes : 0.0;
+    std::cout << "[SVS] modo=" << SvsForwardingModeName(mode) << " Interests /ndn/svs enviados=" << svsInterests
+              << " (" << perNode << "/nó) Nacks Duplicate=" << duplicateNacks << std::endl;
+
+    AppendCsvRow(filename, "mode,runId,nodes,svsInterests,svsInterestsPerNode,duplicateNacks",
+                 SvsForwardingModeName(mode), RngSeedManager::GetRun(), nodes, svsInterests, perNode, duplicateNacks);
+}
+
+} // namespace ns3
+
+#endif // SVS_FORWARDING_HPP
@@ -0,0 +1,333 @@
+#ifndef TOPOLOGY_LOADER_HPP
+#define TOPOLOGY_LOADER_HPP
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "sim-common.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+// -------------------- Topology Loader --------------------
+// Topologias arbitrárias (malhas irregulares) descritas num ficheiro de texto anotado,
+// uma diretiva por linha ('#' inicia um comentário):
+//
+//   node <nome> [<x> <y>] [point|pivot|router[,...]]
+//   link <a> <b> <rate> <delay> [<loss>]      p.ex. link A B 50Mbps 5ms 0.01
+//   rendezvous <nome>
+//
+// As diretivas podem aparecer por qualquer ordem: um nó é criado na primeira vez que é
+// referido (node ou link). O ficheiro é lido numa única passagem para arrays planos
+// (TopologySpec); só depois se criam, em bloco, os nós, os canais e os NetDevices.
+// Sem <loss> (ou com '-') a ligação usa o ReceiveErrorModel por omissão (--dropRate).
+// O rendezvous e os nós 'router' não correm a aplicação de sincronização.
+// gen-topology.py gera malhas aleatórias neste formato (ver --topologyLoadOnly em large-grid).
+struct TopologySpec {
+    static const uint8_t kRolePoint = 1;
+    static const uint8_t kRolePivot = 2;
+    static const uint8_t kRoleRouter = 4;
+
+    struct Link {
+        uint32_t a;
+        uint32_t b;
+        uint32_t rate;  // índice em rates
+        uint32_t delay; // índice em delays
+        float loss;     // < 0: modelo de erro por omissão
+    };
+
+    std::vector<std::string> names;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<uint8_t> roles;
+    std::vector<Link> links;
+    std::vector<std::string> rates;  // valores distintos (normalmente poucos)
+    std::vector<std::string> delays;
+    int32_t rendezvous{-1};
+
+    size_t NodeCount() const { return names.size(); }
+    bool Has(uint32_t i, uint8_t role) const { return (roles[i] & role) != 0; }
+    bool IsParticipant(uint32_t i) const { return int32_t(i) != rendezvous && !Has(i, kRoleRouter); }
+
+    size_t Count(uint8_t role) const {
+        size_t n = 0;
+        for (uint8_t r : roles) n += (r & role) ? 1 : 0;
+        return n;
+    }
+
+    // Ligações de uma árvore de cobertura (BFS) com raiz no rendezvous, para o modo tree de /ndn/svs.
+    std::vector<bool> SpanningTreeLinks() const {
+        std::vector<bool> inTree(links.size(), false);
+        if (rendezvous < 0) return inTree;
+        std::vector<uint32_t> offsets(NodeCount() + 1, 0);
+        for (const auto &l : links) { offsets[l.a + 1]++; offsets[l.b + 1]++; }
+        for (size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+        std::vector<uint32_t> adj(offsets.back());
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (uint32_t k = 0; k < links.size(); ++k) {
+            adj[cursor[links[k].a]++] = k;
+            adj[cursor[links[k].b]++] = k;
+        }
+
+        std::vector<bool> visited(NodeCount(), false);
+        std::queue<uint32_t> frontier;
+        visited[rendezvous] = true;
+        frontier.push(rendezvous);
+        while (!frontier.empty()) {
+            uint32_t u = frontier.front();
+            frontier.pop();
+            for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                const Link& l = links[adj[e]];
+                uint32_t v = l.a == u ? l.b : l.a;
+                if (visited[v]) continue;
+                visited[v] = true;
+                inTree[adj[e]] = true;
+                frontier.push(v);
+            }
+        }
+        return inTree;
+    }
+};
+
+class TopologyLoader {
+public:
+    struct Timings {
+        size_t nodes{0};
+        size_t links{0};
+        double parseMs{0.0};
+        double createMs{0.0};
+
+        double TotalMs() const { return parseMs + createMs; }
+    };
+
+    NodeContainer nodes;
+    std::vector<std::pair<Ptr<NetDevice>, Ptr<NetDevice>>> devices; // por ligação, (a, b)
+    TopologySpec spec;
+    Timings timings;
+
+    // Lê e instancia a topologia; devolve false (com a mensagem em error) se o ficheiro for inválido.
+    bool Load(const std::string& path, std::string& error) {
+        auto t0 = std::chrono::steady_clock::now();
+        if (!Parse(path, spec, error)) return false;
+        auto t1 = std::chrono::steady_clock::now();
+        Build();
+        auto t2 = std::chrono::steady_clock::now();
+
+        timings.nodes = spec.NodeCount();
+        timings.links = spec.links.size();
+        timings.parseMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        timings.createMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        return true;
+    }
+
+    // Posição do nó i: a do ficheiro ou, sem coordenadas, uma grelha de 100 m pela ordem dos nós.
+    Vector Position(uint32_t i) const {
+        if (!std::isnan(spec.x[i])) return Vector(spec.x[i], spec.y[i], 0.0);
+        uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(double(spec.NodeCount()))));
+        return Vector((i % side) * 100.0 + 100.0, (i / side) * 100.0 + 100.0, 0.0);
+    }
+
+    void Report(const std::string& path, const std::string& filename = "topology_load.csv") const {
+        std::cout << "[TOPOLOGY] " << path << ": nós=" << timings.nodes << " ligações=" << timings.links
+                  << " parse=" << timings.parseMs << "ms criação=" << timings.createMs
+                  << "ms total=" << timings.TotalMs() << "ms" << std::endl;
+
+        AppendCsvRow(filename, "file,nodes,links,parseMs,createMs,totalMs", path, timings.nodes, timings.links,
+                     timings.parseMs, timings.createMs, timings.TotalMs());
+    }
+
+    static bool Parse(const std::string& path, TopologySpec& spec, std::string& error) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            error = "não foi possível abrir " + path;
+            return false;
+        }
+
+        std::unordered_map<std::string, uint32_t> indexByName;
+        std::unordered_map<std::string, uint32_t> rateIndex;
+        std::unordered_map<std::string, uint32_t> delayIndex;
+        auto nodeIndex = [&](const std::string& name) {
+            auto it = indexByName.find(name);
+            if (it != indexByName.end()) return it->second;
+            uint32_t i = spec.names.size();
+            indexByName.emplace(name, i);
+            spec.names.push_back(name);
+            spec.x.push_back(std::numeric_limits<double>::quiet_NaN());
+            spec.y.push_back(std::numeric_limits<double>::quiet_NaN());
+            spec.roles.push_back(0);
+            return i;
+        };
+        auto intern = [](std::unordered_map<std::string, uint32_t>& index, std::vector<std::string>& values,
+                         const std::string& value) {
+            auto it = index.find(value);
+            if (it != index.end()) return it->second;
+            uint32_t i = values.size();
+            index.emplace(value, i);
+            values.push_back(value);
+            return i;
+        };
+
+        std::string line;
+        std::vector<std::string> tok;
+        std::string rendezvousName;
+        size_t lineNo = 0;
+        while (std::getline(in, line)) {
+            lineNo++;
+            Tokenize(line, tok);
+            if (tok.empty()) continue;
+
+            const std::string& kind = tok[0];
+            if (kind == "link") {
+                if (tok.size() < 5) return Fail(error, path, lineNo, "link <a> <b> <rate> <delay> [<loss>]");
+                TopologySpec::Link l;
+                l.a = nodeIndex(tok[1]);
+                l.b = nodeIndex(tok[2]);
+                if (l.a == l.b) return Fail(error, path, lineNo, "ligação de um nó a si próprio");
+                l.rate = intern(rateIndex, spec.rates, tok[3]);
+                l.delay = intern(delayIndex, spec.delays, tok[4]);
+                l.loss = -1.0f;
+                if (tok.size() > 5 && tok[5] != "-") {
+                    char* end = nullptr;
+                    l.loss = std::strtof(tok[5].c_str(), &end);
+                    if (*end != '\0' || l.loss < 0.0f || l.loss > 1.0f) return Fail(error, path, lineNo, "loss inválido");
+                }
+                spec.links.push_back(l);
+            } else if (kind == "node") {
+                if (tok.size() < 2) return Fail(error, path, lineNo, "node <nome> [<x> <y>] [papéis]");
+                uint32_t i = nodeIndex(tok[1]);
+                size_t next = 2;
+                if (tok.size() >= 4 && IsNumber(tok[2]) && IsNumber(tok[3])) {
+                    spec.x[i] = std::atof(tok[2].c_str());
+                    spec.y[i] = std::atof(tok[3].c_str());
+                    next = 4;
+                }
+                for (; next < tok.size(); ++next) {
+                    if (!ParseRoles(tok[next], spec.roles[i])) return Fail(error, path, lineNo, "papel desconhecido '" + tok[next] + "'");
+                }
+            } else if (kind == "rendezvous") {
+                if (tok.size() != 2) return Fail(error, path, lineNo, "rendezvous <nome>");
+                rendezvousName = tok[1];
+            } else {
+                return Fail(error, path, lineNo, "diretiva desconhecida '" + kind + "'");
+            }
+        }
+
+        if (rendezvousName.empty()) {
+            error = path + ": falta a diretiva rendezvous";
+            return false;
+        }
+        auto it = indexByName.find(rendezvousName);
+        if (it == indexByName.end()) {
+            error = path + ": rendezvous '" + rendezvousName + "' não é um nó da topologia";
+            return false;
+        }
+        spec.rendezvous = it->second;
+        // O rendezvous é o destino dos Points: não pode ser ele próprio point ou pivot
+        uint8_t& rvRoles = spec.roles[spec.rendezvous];
+        if (rvRoles & (TopologySpec::kRolePoint | TopologySpec::kRolePivot)) {
+            std::cerr << "[TOPOLOGY] " << path << ": papéis point/pivot do rendezvous '" << rendezvousName
+                      << "' ignorados" << std::endl;
+            rvRoles &= ~(TopologySpec::kRolePoint | TopologySpec::kRolePivot);
+        }
+        return true;
+    }
+
+private:
+    // Criação em bloco: todos os nós de uma vez e, por ligação, dois NetDevices e um canal
+    // construídos diretamente (sem o ObjectFactory do PointToPointHelper), com os valores
+    // de rate/delay e os modelos de erro convertidos uma única vez por valor distinto.
+    void Build() {
+        nodes.Create(spec.NodeCount());
+
+        std::vector<DataRate> rates;
+        rates.reserve(spec.rates.size());
+        for (const auto &r : spec.rates) rates.emplace_back(r);
+        std::vector<Time> delays;
+        delays.reserve(spec.delays.size());
+        for (const auto &d : spec.delays) delays.emplace_back(d);
+        std::map<float, Ptr<RateErrorModel>> errorModels;
+
+        devices.reserve(spec.links.size());
+        for (const auto &l : spec.links) {
+            Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+            channel->SetAttribute("Delay", TimeValue(delays[l.delay]));
+
+            Ptr<RateErrorModel> em;
+            if (l.loss >= 0.0f) {
+                Ptr<RateErrorModel>& cached = errorModels[l.loss];
+                if (!cached) {
+                    cached = CreateObject<RateErrorModel>();
+                    cached->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+                    cached->SetRate(l.loss);
+                }
+                em = cached;
+            }
+
+            Ptr<PointToPointNetDevice> ends[2];
+            uint32_t endpoints[2] = {l.a, l.b};
+            for (int k = 0; k < 2; ++k) {
+                ends[k] = CreateObject<PointToPointNetDevice>();
+                ends[k]->SetAddress(Mac48Address::Allocate());
+                ends[k]->SetDataRate(rates[l.rate]);
+                ends[k]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+                if (em) ends[k]->SetReceiveErrorModel(em);
+                nodes.Get(endpoints[k])->AddDevice(ends[k]);
+                ends[k]->Attach(channel);
+            }
+            devices.emplace_back(ends[0], ends[1]);
+        }
+    }
+
+    static void Tokenize(const std::string& line, std::vector<std::string>& tok) {
+        tok.clear();
+        size_t i = 0, n = line.size();
+        while (i < n) {
+            while (i < n && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+            if (i >= n || line[i] == '#') break;
+            size_t start = i;
+            while (i < n && line[i] != ' ' && line[i] != '\t' && line[i] != '\r' && line[i] != '#') ++i;
+            tok.emplace_back(line, start, i - start);
+        }
+    }
+
+    static bool IsNumber(const std::string& s) {
+        char* end = nullptr;
+        std::strtod(s.c_str(), &end);
+        return end != s.c_str() && *end == '\0';
+    }
+
+    static bool ParseRoles(const std::string& list, uint8_t& roles) {
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t comma = list.find(',', start);
+            std::string role = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            if (role == "point") roles |= TopologySpec::kRolePoint;
+            else if (role == "pivot") roles |= TopologySpec::kRolePivot;
+            else if (role == "router") roles |= TopologySpec::kRoleRouter;
+            else if (role != "-" && !role.empty()) return false;
+            if (comma == std::string::npos) break;
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    static bool Fail(std::string& error, const std::string& path, size_t lineNo, const std::string& what) {
+        error = path + ":" + std::to_string(lineNo) + ": " + what;
+        return false;
+    }
+};
+
+} // namespace ns3
+
+#endif // TOPOLOGY_LOADER_HPP